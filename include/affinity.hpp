@@ -0,0 +1,101 @@
+/***************************************************************************
+ *            affinity.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file affinity.hpp
+ *  \brief Classes for placing threads on processors according to the topology of the machine.
+ */
+
+#ifndef PEXPLORE_AFFINITY_HPP
+#define PEXPLORE_AFFINITY_HPP
+
+#include <optional>
+#include "helper/container.hpp"
+#include "helper/string.hpp"
+#include "helper/writable.hpp"
+
+namespace pExplore {
+
+using Helper::List;
+using Helper::String;
+using Helper::WritableInterface;
+using std::size_t;
+
+//! \brief The location of a logical processor in the topology of the machine
+struct ProcessorLocation {
+    size_t cpu;
+    size_t package; // The socket
+    size_t core; // Within the package
+    size_t node; // The NUMA node
+};
+
+//! \brief The processors in a list such as "0-3,8,10-11", as used by sysfs
+List<size_t> parse_processor_list(String const& text);
+
+//! \brief The locations of the online processors allowed by the affinity mask of the process, as given by the sysfs in \a root
+//! \details Returns an empty list where the topology is not available
+List<ProcessorLocation> read_processor_topology(String const& root = "/sys/devices/system/cpu");
+
+//! \brief Pin the calling thread to \a cpu, returning whether supported and successful
+//! \details Memory first touched by the thread afterwards is allocated on the NUMA node of \a cpu under the default policy
+bool pin_current_thread(size_t cpu);
+
+//! \brief How to place the threads of a runner on the processors
+class AffinityPolicy : public WritableInterface {
+  public:
+    enum class Kind { NONE, COMPACT, SCATTER, EXPLICIT };
+  private:
+    AffinityPolicy(Kind kind, List<size_t> const& cpus);
+  public:
+    //! \brief No placement, leaving threads to the scheduler
+    static AffinityPolicy none();
+    //! \brief Threads on consecutive cores of the same package, then on their hardware threads
+    static AffinityPolicy compact();
+    //! \brief Threads spread across packages, then across cores within each package, then on their hardware threads
+    static AffinityPolicy scatter();
+    //! \brief Threads on the given \a cpus, in turn
+    static AffinityPolicy explicit_cpus(List<size_t> const& cpus);
+
+    Kind kind() const;
+
+    //! \brief The processor for each of \a num_threads threads, given the \a topology, or empty if threads are not to be placed
+    //! \details Processors are reused in turn when there are more threads than processors
+    List<size_t> assign(List<ProcessorLocation> const& topology, size_t num_threads) const;
+    //! \brief The processor for the thread of index \a thread, given the \a topology, or empty if threads are not to be placed
+    //! \details The same as from assign() for any number of threads, which only extends the processors of the threads before
+    std::optional<size_t> processor_for(List<ProcessorLocation> const& topology, size_t thread) const;
+
+    std::ostream& _write(std::ostream& os) const override;
+
+  private:
+    Kind _kind;
+    List<size_t> _cpus;
+};
+
+} // namespace pExplore
+
+#endif // PEXPLORE_AFFINITY_HPP
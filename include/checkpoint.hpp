@@ -0,0 +1,104 @@
+/***************************************************************************
+ *            checkpoint.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file checkpoint.hpp
+ *  \brief Classes and functions for checkpointing a parameter search.
+ */
+
+#ifndef PEXPLORE_CHECKPOINT_HPP
+#define PEXPLORE_CHECKPOINT_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <condition_variable>
+#include "betterthreads/thread.hpp"
+#include "helper/container.hpp"
+#include "helper/string.hpp"
+#include "score.hpp"
+
+namespace pExplore {
+
+using BetterThreads::Thread;
+using Helper::List;
+using Helper::String;
+
+//! \brief Writes checkpoint data to a file in a dedicated thread
+//! \details Only the latest state is kept: a state not yet written when a new one arrives is superseded.
+//! The scores of each step are instead appended to a separate history file, whose length in steps and bytes
+//! is written after the state, so that the cost of a checkpoint does not grow with the number of steps.
+//! The file is replaced atomically, hence an interruption or a failed write leaves the previous checkpoint intact.
+class CheckpointWriter {
+  public:
+    CheckpointWriter(String const& filename);
+    ~CheckpointWriter();
+
+    String const& filename() const;
+    //! \brief The file holding the history of the scores for the checkpoint in \a filename
+    static String history_filename(String const& filename);
+
+    //! \brief Schedule the writing of \a state, with \a step_scores appended to the history, without waiting for it to happen
+    void write(String const& state, List<PointScore> const& step_scores);
+    //! \brief Start the history anew from \a history, e.g., when restoring from a checkpoint
+    //! \details The history file is rewritten on the next write
+    void reset_history(List<List<PointScore>> const& history);
+    //! \brief Wait until all scheduled data has been written
+    void flush();
+
+  private:
+    void _loop();
+    //! \brief Append \a history_data to the history file, returning whether successful
+    bool _append_history(String const& history_data);
+    //! \brief Write \a data to a temporary file and rename it over the checkpoint
+    //! \details Failures are logged and leave the previous checkpoint in place, nothing is thrown
+    void _write_file(String const& data) const;
+  private:
+    String const _filename;
+    std::mutex _mutex;
+    std::condition_variable _availability;
+    std::condition_variable _completion;
+    String _pending;
+    List<List<PointScore>> _pending_scores;
+    bool _has_pending;
+    bool _reset_pending;
+    bool _writing;
+    bool _terminate;
+    // Used by the writing thread only
+    String _unwritten_history;
+    std::uint64_t _unwritten_steps;
+    std::uint64_t _history_steps;
+    std::uint64_t _history_size;
+    Thread _thread;
+};
+
+//! \brief Read the whole content of the binary file \a filename
+//! \details Throws DeserialisationException if the file cannot be opened
+String read_binary_file(String const& filename);
+
+} // namespace pExplore
+
+#endif // PEXPLORE_CHECKPOINT_HPP
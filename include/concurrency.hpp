@@ -0,0 +1,59 @@
+/***************************************************************************
+ *            concurrency.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/*! \file concurrency.hpp
+ *  \brief Functions for detecting the processors actually available to the process.
+ */
+
+#ifndef PEXPLORE_CONCURRENCY_HPP
+#define PEXPLORE_CONCURRENCY_HPP
+
+#include <optional>
+#include "helper/string.hpp"
+
+namespace pExplore {
+
+using Helper::String;
+using std::size_t;
+
+//! \brief The number of processors from the content of a cgroup v2 cpu.max file, i.e., "<quota> <period>" or "max <period>"
+//! \details The quota is rounded up; returns nothing if unlimited or malformed
+std::optional<size_t> cgroup_v2_cpu_limit(String const& cpu_max);
+//! \brief The number of processors from the contents of cgroup v1 cpu.cfs_quota_us and cpu.cfs_period_us files
+//! \details The quota is rounded up; returns nothing if unlimited (a negative quota) or malformed
+std::optional<size_t> cgroup_v1_cpu_limit(String const& quota, String const& period);
+
+//! \brief The number of processors available to the process
+//! \details The minimum among the hardware concurrency, the affinity mask and the CPU quota of the cgroup (v1 or v2) of
+//! the process and its ancestors, where supported, and at least 1
+size_t available_concurrency();
+
+} // namespace pExplore
+
+#endif // PEXPLORE_CONCURRENCY_HPP
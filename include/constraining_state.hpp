@@ -33,9 +33,11 @@
 #ifndef PEXPLORE_CONSTRAINING_STATE
 #define PEXPLORE_CONSTRAINING_STATE
 
+#include <tuple>
 #include "helper/container.hpp"
 #include "helper/writable.hpp"
 #include "constraint.hpp"
+#include "serialisation.hpp"
 
 namespace pExplore {
 
@@ -45,6 +47,21 @@ using std::to_string;
 using std::ostream;
 using std::min;
 
+//! \brief An evaluator of the score of a fixed set of constraints, as an alternative to evaluating them one by one
+//! \details The evaluator holds no state, the activity and the controllers being taken from the constraint states
+template<class R> class ConstraintSetEvaluatorInterface {
+  public:
+    typedef TaskInput<R> InputType;
+    typedef TaskOutput<R> OutputType;
+
+    //! \brief Whether the evaluator can be used in place of evaluating \a constraints one by one
+    virtual bool is_compatible_with(List<Constraint<R>> const& constraints) const = 0;
+    //! \brief Evaluate the active constraints among \a states given an \a input and \a output, optionally updating their controllers with \a update_controller
+    virtual Score evaluate(List<ConstraintState<R>> const& states, InputType const& input, OutputType const& output, bool update_controller) const = 0;
+
+    virtual ~ConstraintSetEvaluatorInterface() = default;
+};
+
 template<class R> class ConstrainingState : public WritableInterface {
   public:
     typedef TaskInput<R> InputType;
@@ -56,6 +73,12 @@ template<class R> class ConstrainingState : public WritableInterface {
         }
     }
 
+    //! \brief Construct from \a constraints, whose scores are computed by \a evaluator, if not null
+    ConstrainingState(List<Constraint<R>> const& constraints, shared_ptr<ConstraintSetEvaluatorInterface<R> const> const& evaluator) : ConstrainingState(constraints) {
+        HELPER_PRECONDITION(evaluator == nullptr or evaluator->is_compatible_with(constraints))
+        _evaluator = evaluator;
+    }
+
     ConstrainingState() : ConstrainingState(List<Constraint<R>>()) { }
 
     PointScore evaluate(ConfigurationSearchPoint const& point, InputType const& input, OutputType const& output) const {
@@ -64,6 +87,7 @@ template<class R> class ConstrainingState : public WritableInterface {
 
     Score evaluate(InputType const& input, OutputType const& output, bool update_controller) const {
         HELPER_PRECONDITION(not has_no_active_constraints())
+        if (_evaluator != nullptr) return _evaluator->evaluate(_states,input,output,update_controller);
         double objective = 0.0;
         Set<size_t> successes;
         Set<size_t> hard_failures;
@@ -145,6 +169,9 @@ template<class R> class ConstrainingState : public WritableInterface {
         return _states;
     }
 
+    //! \brief The evaluator of the scores, null if the constraints are evaluated one by one
+    shared_ptr<ConstraintSetEvaluatorInterface<R> const> const& evaluator() const { return _evaluator; }
+
     List<Constraint<R>> constraints() const {
         List<Constraint<R>> result;
         for (auto const& s : _states) {
@@ -153,6 +180,52 @@ template<class R> class ConstrainingState : public WritableInterface {
         return result;
     }
 
+    //! \brief Write the state of the constraints, including their controllers
+    void save_state(BinaryWriter& writer) const {
+        writer.write<std::uint64_t>(_states.size());
+        writer.write<std::uint64_t>(_num_active_constraints);
+        for (auto const& s : _states) {
+            writer.write(s.is_active());
+            writer.write(s.has_succeeded());
+            writer.write(s.has_failed());
+            writer.write(s.constraint().controller().state());
+        }
+    }
+
+    //! \brief A copy whose constraints have their own controllers, hence can be changed independently
+    ConstrainingState<R> clone() const {
+        ConstrainingState<R> result(*this);
+        for (auto& s : result._states) s = s.clone();
+        return result;
+    }
+
+    //! \brief Read the state of the constraints as written by save_state
+    //! \details The constraints must be the same as those used when saving. The whole state is read and validated
+    //! before being applied, hence nothing is changed if a DeserialisationException is thrown.
+    //! Since copies share controllers, this should be called on a clone when the current state must be kept.
+    void load_state(BinaryReader& reader) {
+        auto num_states = static_cast<size_t>(reader.read<std::uint64_t>());
+        if (num_states != _states.size())
+            throw DeserialisationException("Saved constraints are " + to_string(num_states) + ", expected " + to_string(_states.size()));
+        auto num_active_constraints = static_cast<size_t>(reader.read<std::uint64_t>());
+        List<std::tuple<bool,bool,bool,List<double>>> saved;
+        for (auto const& s : _states) {
+            auto active = reader.read<bool>();
+            auto success = reader.read<bool>();
+            auto failure = reader.read<bool>();
+            auto controller_state = reader.read_doubles();
+            if (controller_state.size() != s.constraint().controller().state().size())
+                throw DeserialisationException("Saved controller state of constraint '" + s.constraint().name() + "' has size " + to_string(controller_state.size()) +
+                                               ", expected " + to_string(s.constraint().controller().state().size()));
+            saved.emplace_back(active,success,failure,controller_state);
+        }
+        for (size_t i=0; i<_states.size(); ++i) {
+            auto const& [active,success,failure,controller_state] = saved.at(i);
+            _states.at(i).restore(active,success,failure,controller_state);
+        }
+        _num_active_constraints = num_active_constraints;
+    }
+
     virtual ostream& _write(ostream& os) const {
         return os << "{" << _states << ": " << "}";
     }
@@ -160,6 +233,7 @@ template<class R> class ConstrainingState : public WritableInterface {
   private:
     List<ConstraintState<R>> _states;
     size_t _num_active_constraints;
+    shared_ptr<ConstraintSetEvaluatorInterface<R> const> _evaluator;
 };
 
 template<class R> struct NoActiveConstraintsException : public std::runtime_error {
@@ -49,6 +49,7 @@ using Helper::WritableInterface;
 using Helper::String;
 using Helper::Set;
 using Helper::Map;
+using Helper::List;
 using ProNest::ConfigurationSearchPoint;
 using std::ostream;
 using std::shared_ptr;
@@ -122,9 +123,23 @@ template<class R> class Constraint : public WritableInterface {
     ConstraintObjectiveImpact objective_impact() const { return _objective_impact; }
 
     RobustnessControllerInterface<R> const& controller() const { return *_controller_ptr; }
+    //! \brief Restore the internal \a state of the controller
+    void set_controller_state(List<double> const& state) { _controller_ptr->set_state(state); }
+    //! \brief A copy with its own controller in the same state, since copies otherwise share the controller
+    Constraint<R> clone() const {
+        Constraint<R> result(*this);
+        result._controller_ptr.reset(_controller_ptr->clone());
+        result._controller_ptr->set_state(_controller_ptr->state());
+        return result;
+    }
 
     //! \brief Get the degree of satisfaction of the constraint given an \a input and \a output, optionally updating the robustness controller with \a update
     double robustness(InputType const& input, OutputType const& output, bool update_controller) const { return _controller_ptr->apply(_func(input, output),input,output,update_controller); }
+    //! \brief Apply the controller to the \a value of the constraint function, as robustness() does, with the controller known to be of type \a CTRL
+    //! \details The call is resolved statically, hence the controller must have been set as a \a CTRL
+    template<class CTRL> double controlled_robustness(double value, InputType const& input, OutputType const& output, bool update_controller) const {
+        return static_cast<CTRL&>(*_controller_ptr).CTRL::apply(value,input,output,update_controller);
+    }
 
     ostream& _write(ostream& os) const override {
         return os << "{'" << _name << "', group_id=" << _group_id << ", success_action=" << _success_action << ", failure_kind=" << _failure_kind << ", objective_impact=" << _objective_impact << "}";
@@ -185,6 +200,17 @@ template<class R> class ConstraintState : public WritableInterface {
     void deactivate() { _active = false; }
     void set_success() { HELPER_PRECONDITION(not _failure) _success = true; }
     void set_failure() { HELPER_PRECONDITION(not _success) _failure = true; }
+    //! \brief A copy whose constraint has its own controller
+    ConstraintState<R> clone() const {
+        ConstraintState<R> result(*this);
+        result._constraint = _constraint.clone();
+        return result;
+    }
+    //! \brief Restore the flags and the \a controller_state, e.g., from a checkpoint
+    void restore(bool active, bool success, bool failure, List<double> const& controller_state) {
+        _active = active; _success = success; _failure = failure;
+        _constraint.set_controller_state(controller_state);
+    }
 
     ostream& _write(ostream& os) const override {
         return os << "{" << _constraint << ", active=" << _active << ", has_succeeded=" << _success << ", has_failed=" << _failure << "}";
@@ -0,0 +1,97 @@
+/***************************************************************************
+ *            decision_log.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/*! \file decision_log.hpp
+ *  \brief Classes for recording and replaying the decisions of a parameter search.
+ */
+
+#ifndef PEXPLORE_DECISION_LOG_HPP
+#define PEXPLORE_DECISION_LOG_HPP
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include "helper/container.hpp"
+#include "helper/string.hpp"
+#include "pronest/configuration_search_point.hpp"
+#include "pronest/configuration_search_space.hpp"
+
+namespace pExplore {
+
+using Helper::List;
+using Helper::Set;
+using Helper::String;
+using ProNest::ConfigurationSearchPoint;
+using ProNest::ConfigurationSearchSpace;
+using std::ostream;
+
+//! \brief The decisions taken by a parameter search on the points to evaluate
+enum class DecisionKind { INITIAL, CONTEXTUALISED, SCREENED, NEXT, RESIZED };
+ostream& operator<<(ostream& os, DecisionKind kind);
+
+//! \brief Exception for a replay that diverges from the recorded decisions
+struct DecisionReplayException : public std::runtime_error {
+    DecisionReplayException(String const& what) : std::runtime_error(what) { }
+};
+
+//! \brief A log of decisions in a text file, either being recorded or being replayed
+//! \details In recording mode the file is replaced, and each decision is flushed as soon as it is taken, so that
+//! the log survives a crash. In replay mode, decisions must be requested in the same order as they were recorded.
+class DecisionLog {
+  public:
+    enum class Mode { RECORD, REPLAY };
+
+    DecisionLog(String const& filename, Mode mode);
+    DecisionLog(DecisionLog const&) = delete;
+    void operator=(DecisionLog const&) = delete;
+
+    String const& filename() const;
+    Mode mode() const;
+    bool is_replaying() const;
+
+    //! \brief Record the \a points decided for \a kind
+    void record(DecisionKind kind, Set<ConfigurationSearchPoint> const& points);
+    //! \brief Replay the next decision, which must be of the given \a kind, with points in \a space
+    //! \details Throws DecisionReplayException if the log is exhausted or the decision is of another kind
+    Set<ConfigurationSearchPoint> replay(DecisionKind kind, ConfigurationSearchSpace const& space);
+
+    //! \brief The number of decisions recorded, or still to replay
+    size_t size() const;
+
+  private:
+    String _filename;
+    Mode _mode;
+    std::ofstream _file;
+    List<std::pair<DecisionKind,List<List<int>>>> _decisions;
+    size_t _next;
+};
+
+} // namespace pExplore
+
+#endif // PEXPLORE_DECISION_LOG_HPP
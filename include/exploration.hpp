@@ -33,29 +33,170 @@
 #ifndef PEXPLORE_EXPLORATION_HPP
 #define PEXPLORE_EXPLORATION_HPP
 
+#include <deque>
+#include <random>
+#include <unordered_map>
+#include <utility>
 #include "pronest/configuration_search_point.hpp"
 #include "helper/container.hpp"
 #include "score.hpp"
+#include "search_point_key.hpp"
+#include "serialisation.hpp"
+#include "shifting.hpp"
+#include "visited_points.hpp"
 
 namespace pExplore {
 
 using Helper::Set;
+using Helper::List;
+using std::shared_ptr;
 
 //! \brief Interface for search strategies
 class ExplorationInterface {
   public:
-    //! \brief Make the next points from set of points from \a rankings, preserving the size
-    virtual Set<ConfigurationSearchPoint> next_points_from(Set<PointScore> const& rankings) const = 0;
+    //! \brief Make the next points from the unordered \a scores, preserving the size
+    //! \details The exploration may keep a state across calls, hence each runner should use its own clone
+    virtual Set<ConfigurationSearchPoint> next_points_from(List<PointScore> const& scores) = 0;
+    //! \brief Adapt the \a points about to be evaluated to an input characterised by \a features, preserving the size
+    //! \details The default ignores the context
+    virtual Set<ConfigurationSearchPoint> contextualise(List<double> const&, Set<ConfigurationSearchPoint> const& points) { return points; }
+
+    //! \brief Seed all the stochastic choices, so that the same seed and scores yield the same points
+    virtual void set_seed(std::uint64_t seed) = 0;
+
+    //! \brief Write the state kept across calls, for checkpointing
+    //! \details The default has no state
+    virtual void save_state(BinaryWriter&) const { }
+    //! \brief Read the state as written by save_state on an exploration with the same construction parameters,
+    //! where \a space is the search space of the points
+    virtual void load_state(BinaryReader&, ConfigurationSearchSpace const&) { }
 
     virtual ExplorationInterface* clone() const = 0;
     virtual ~ExplorationInterface() = default;
 };
 
 //! \brief Keeps the best half points, to which we add the shifted points from each (with a distance 1 if possible)
+//! \details Shifted points that have not been visited yet are preferred
 class ShiftAndKeepBestHalfExploration : public ExplorationInterface {
   public:
-    Set<ConfigurationSearchPoint> next_points_from(Set<PointScore> const& rankings) const override;
+    ShiftAndKeepBestHalfExploration();
+    Set<ConfigurationSearchPoint> next_points_from(List<PointScore> const& scores) override;
+    void set_seed(std::uint64_t seed) override;
+    void save_state(BinaryWriter& writer) const override;
+    void load_state(BinaryReader& reader, ConfigurationSearchSpace const& space) override;
+    ExplorationInterface* clone() const override;
+
+    //! \brief The memory of visited points, null before the first call to next_points_from
+    shared_ptr<VisitedPoints> const& visited() const;
+  private:
+    shared_ptr<VisitedPoints> _visited;
+    RandomGenerator _generator;
+};
+
+//! \brief Fits a kernel regression model to the history of scores, proposing the shifted points with the best expected improvement
+//! \details Since scores are not scalar, the scores of each step are converted into ranks in [0,1], with 0 for the best.
+//! The model keeps the latest \a history_size ranked points, using a Gaussian kernel of the given \a bandwidth on coordinates
+//! normalised to [0,1]. For each point to fill, \a candidates_multiplier shifted candidates are ranked by the model.
+class SurrogateModelExploration : public ExplorationInterface {
+  public:
+    SurrogateModelExploration(size_t history_size = 1024, double bandwidth = 0.2, size_t candidates_multiplier = 8);
+    Set<ConfigurationSearchPoint> next_points_from(List<PointScore> const& scores) override;
+    void set_seed(std::uint64_t seed) override;
+    void save_state(BinaryWriter& writer) const override;
+    void load_state(BinaryReader& reader, ConfigurationSearchSpace const& space) override;
     ExplorationInterface* clone() const override;
+
+    //! \brief The number of ranked points currently used by the model
+    size_t history_size() const;
+    //! \brief The predicted rank of \a point, along with its standard deviation
+    std::pair<double,double> predict(ConfigurationSearchPoint const& point) const;
+
+  private:
+    List<double> _normalised(ConfigurationSearchPoint const& point) const;
+    std::pair<double,double> _predict(List<double> const& x) const;
+    double _expected_improvement(List<double> const& x) const;
+  private:
+    size_t _history_capacity;
+    double _bandwidth;
+    size_t _candidates_multiplier;
+    List<double> _offsets;
+    List<double> _scales;
+    std::deque<std::pair<List<double>,double>> _history;
+    RandomGenerator _generator;
+};
+
+//! \brief Runs a portfolio of explorations, splitting the new points of each step among them with a multi-armed bandit
+//! \details The best half of the points is always kept. The remaining slots are allocated in proportion to the UCB1 index
+//! of each exploration, with at least one slot each when possible. The reward of an exploration for a step is the fraction
+//! of its new points that rank in the best half of that step, with \a confidence weighting the UCB1 exploration term.
+class PortfolioExploration : public ExplorationInterface {
+  public:
+    PortfolioExploration(double confidence = 1.0);
+    //! \brief Add a clone of \a exploration to the portfolio
+    PortfolioExploration& add(ExplorationInterface const& exploration);
+
+    Set<ConfigurationSearchPoint> next_points_from(List<PointScore> const& scores) override;
+    void set_seed(std::uint64_t seed) override;
+    void save_state(BinaryWriter& writer) const override;
+    void load_state(BinaryReader& reader, ConfigurationSearchSpace const& space) override;
+    ExplorationInterface* clone() const override;
+
+    //! \brief The number of explorations in the portfolio
+    size_t size() const;
+    //! \brief The mean reward of each exploration
+    List<double> mean_rewards() const;
+    //! \brief The number of new points allocated to each exploration at the last step
+    List<size_t> const& allocations() const;
+
+  private:
+    void _update_rewards(List<PointScore> const& scores, Set<ConfigurationSearchPoint> const& kept);
+    List<size_t> _allocate(size_t slots) const;
+  private:
+    double _confidence;
+    List<shared_ptr<ExplorationInterface>> _explorations;
+    List<double> _reward_sums;
+    List<size_t> _rewarded_steps;
+    List<size_t> _allocations;
+    size_t _steps;
+    shared_ptr<SearchPointEncoder> _encoder;
+    std::unordered_map<SearchPointKey,size_t> _proposers;
+    RandomGenerator _generator;
+};
+
+//! \brief Wraps an exploration, remembering the best point for each context of the input
+//! \details Contexts are clusters of feature vectors: a vector belongs to the nearest cluster within \a radius,
+//! otherwise it starts a new one, up to \a max_contexts. When the context changes to one already seen,
+//! half of the points are replaced by its best point and shifts around it, so that the search restarts from there.
+class ContextualExploration : public ExplorationInterface {
+  public:
+    ContextualExploration(ExplorationInterface const& exploration, double radius, size_t max_contexts = 64);
+
+    Set<ConfigurationSearchPoint> next_points_from(List<PointScore> const& scores) override;
+    Set<ConfigurationSearchPoint> contextualise(List<double> const& features, Set<ConfigurationSearchPoint> const& points) override;
+    void set_seed(std::uint64_t seed) override;
+    void save_state(BinaryWriter& writer) const override;
+    void load_state(BinaryReader& reader, ConfigurationSearchSpace const& space) override;
+    ExplorationInterface* clone() const override;
+
+    //! \brief The number of contexts identified
+    size_t num_contexts() const;
+    //! \brief The index of the current context
+    size_t current_context() const;
+
+  private:
+    struct Context {
+        List<double> centroid;
+        size_t count;
+        shared_ptr<ConfigurationSearchPoint> best_point;
+    };
+    size_t _context_for(List<double> const& features);
+  private:
+    shared_ptr<ExplorationInterface> _exploration;
+    double _radius;
+    size_t _max_contexts;
+    List<Context> _contexts;
+    size_t _current;
+    RandomGenerator _generator;
 };
 
 } // namespace pExplore
@@ -0,0 +1,73 @@
+/***************************************************************************
+ *            fidelity.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file fidelity.hpp
+ *  \brief Class for schedules of evaluation fidelities.
+ */
+
+#ifndef PEXPLORE_FIDELITY_HPP
+#define PEXPLORE_FIDELITY_HPP
+
+#include "helper/container.hpp"
+#include "helper/writable.hpp"
+
+namespace pExplore {
+
+using Helper::List;
+using Helper::WritableInterface;
+using std::ostream;
+using std::size_t;
+
+//! \brief A schedule for successive halving over increasing fidelities
+//! \details Each rung but the last evaluates its candidates at the rung fidelity, promoting the best 1/reduction_factor of them
+//! to the next rung. The last rung evaluates at full fidelity as many points as the runner concurrency.
+class SuccessiveHalvingSchedule : public WritableInterface {
+  public:
+    //! \brief Construct the single-fidelity schedule, with no screening
+    SuccessiveHalvingSchedule();
+    //! \brief Construct from the \a screening_fidelities, increasing within (0,1), and the \a reduction_factor
+    SuccessiveHalvingSchedule(List<double> const& screening_fidelities, size_t reduction_factor = 2);
+
+    //! \brief Whether there is no screening at lower fidelities
+    bool is_single_fidelity() const;
+    //! \brief The number of rungs, including the full fidelity one
+    size_t num_rungs() const;
+    //! \brief The fidelity at \a rung
+    double fidelity(size_t rung) const;
+    //! \brief The number of candidates at \a rung, given the number of points \a final_size at full fidelity
+    size_t rung_size(size_t rung, size_t final_size) const;
+
+    ostream& _write(ostream& os) const override;
+  private:
+    List<double> _fidelities;
+    size_t _reduction_factor;
+};
+
+} // namespace pExplore
+
+#endif // PEXPLORE_FIDELITY_HPP
@@ -0,0 +1,97 @@
+/***************************************************************************
+ *            initialisation.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file initialisation.hpp
+ *  \brief Class for strategies to make the initial points of the exploration.
+ */
+
+#ifndef PEXPLORE_INITIALISATION_HPP
+#define PEXPLORE_INITIALISATION_HPP
+
+#include <random>
+#include "pronest/configuration_search_point.hpp"
+#include "helper/container.hpp"
+#include "serialisation.hpp"
+#include "shifting.hpp"
+
+namespace pExplore {
+
+using Helper::Set;
+using ProNest::ConfigurationSearchPoint;
+using std::size_t;
+
+//! \brief Interface for initialisation strategies
+class InitialisationInterface {
+  public:
+    //! \brief Make \a size points to start the exploration from, given the \a initial_point
+    virtual Set<ConfigurationSearchPoint> initial_points(ConfigurationSearchPoint const& initial_point, size_t size) = 0;
+    //! \brief Seed all the stochastic choices, so that the same seed yields the same points
+    virtual void set_seed(std::uint64_t seed) = 0;
+
+    //! \brief Write the state kept across calls, for checkpointing
+    //! \details The default has no state
+    virtual void save_state(BinaryWriter&) const { }
+    //! \brief Read the state as written by save_state on an initialisation with the same construction parameters
+    virtual void load_state(BinaryReader&) { }
+
+    virtual InitialisationInterface* clone() const = 0;
+    virtual ~InitialisationInterface() = default;
+};
+
+//! \brief Randomly shifts from the initial point, which is always included
+class RandomShiftInitialisation : public InitialisationInterface {
+  public:
+    RandomShiftInitialisation();
+    Set<ConfigurationSearchPoint> initial_points(ConfigurationSearchPoint const& initial_point, size_t size) override;
+    void set_seed(std::uint64_t seed) override;
+    void save_state(BinaryWriter& writer) const override;
+    void load_state(BinaryReader& reader) override;
+    InitialisationInterface* clone() const override;
+  private:
+    RandomGenerator _generator;
+};
+
+//! \brief Spreads the points over the whole search space using Latin hypercube sampling
+//! \details Each parameter range is split into as many strata as points, with one point for each stratum;
+//! if \a include_initial_point is true, the initial point is one of the points, replacing the sample of its stratum for each parameter
+class LatinHypercubeInitialisation : public InitialisationInterface {
+  public:
+    LatinHypercubeInitialisation(bool include_initial_point = true);
+    Set<ConfigurationSearchPoint> initial_points(ConfigurationSearchPoint const& initial_point, size_t size) override;
+    void set_seed(std::uint64_t seed) override;
+    void save_state(BinaryWriter& writer) const override;
+    void load_state(BinaryReader& reader) override;
+    InitialisationInterface* clone() const override;
+  private:
+    bool _include_initial_point;
+    RandomGenerator _generator;
+};
+
+} // namespace pExplore
+
+#endif // PEXPLORE_INITIALISATION_HPP
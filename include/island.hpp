@@ -0,0 +1,158 @@
+/***************************************************************************
+ *            island.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/*! \file island.hpp
+ *  \brief Classes for exchanging points between concurrent searches, each one an island of a distributed search.
+ */
+
+#ifndef PEXPLORE_ISLAND_HPP
+#define PEXPLORE_ISLAND_HPP
+
+#if defined(__unix__) || defined(__APPLE__)
+//! \brief Defined when islands can exchange points through sockets
+#define PEXPLORE_HAS_ISLANDS
+#endif
+
+#if defined(PEXPLORE_HAS_ISLANDS)
+
+#include <atomic>
+#include <mutex>
+#include "betterthreads/thread.hpp"
+#include "helper/container.hpp"
+#include "helper/string.hpp"
+#include "exploration.hpp"
+
+namespace pExplore {
+
+using BetterThreads::Thread;
+using Helper::List;
+using Helper::String;
+
+//! \brief Exchanges point scores with peer islands through sockets
+//! \details Addresses are either "unix:<path>" for a local socket, or "tcp:<host>:<port>", where port 0 listens on
+//! any free port. Each message is sent over its own connection, as a frame made of the magic number, the version and
+//! the size of the payload, followed by the payload with the address of the sender and the point scores, all written
+//! as by BinaryWriter. Messages are sent by the thread of the channel, which also receives them, so that the search
+//! never waits for the peers. Peers that cannot be reached are skipped, since islands may start and stop independently.
+class IslandChannel {
+  public:
+    //! \brief Listen for messages at \a address
+    //! \details Fails if a file exists at the path of a "unix:" address, which is removed when the channel is destroyed
+    IslandChannel(String const& address);
+    IslandChannel(IslandChannel const&) = delete;
+    void operator=(IslandChannel const&) = delete;
+    //! \brief Stop listening, after sending the messages queued
+    ~IslandChannel();
+
+    //! \brief The address listened to, with the actual port for TCP
+    String const& address() const;
+
+    //! \brief Add a peer at \a address, resolved once here or, if it cannot be resolved yet, when first sent to
+    void add_peer(String const& address);
+    List<String> peers() const;
+
+    //! \brief Queue \a scores to be sent to all peers
+    void send(List<PointScore> const& scores);
+    //! \brief The number of messages queued and not sent yet
+    size_t num_queued() const;
+    //! \brief The scores received since the last call, with points of \a space
+    //! \details Messages for a space of different dimension are discarded
+    List<PointScore> receive(ConfigurationSearchSpace const& space);
+    //! \brief The number of messages received and not returned by receive() yet
+    size_t num_pending() const;
+
+  private:
+    //! \brief The listening socket, closed on destruction
+    struct Listener {
+        int fd = -1;
+        String path; // Of the socket file to remove, if any
+        ~Listener();
+    };
+    //! \brief A pipe for waking up the thread, closed on destruction
+    struct Wakeup {
+        int fds[2] = {-1,-1};
+        ~Wakeup();
+    };
+    //! \brief A peer with its socket addresses, defined where sockets are available
+    struct Peer;
+    void _loop();
+    //! \brief Wake up the thread, to send the messages queued or to terminate
+    void _wake_up();
+    //! \brief Send the messages queued, from the thread
+    void _send_queued();
+    //! \brief Accept a connection and keep its message, from the thread
+    void _accept();
+  private:
+    String _address;
+    Listener _listener;
+    Wakeup _wakeup;
+    mutable std::mutex _peers_mutex;
+    List<shared_ptr<Peer>> _peers; // Resolved on the thread only, once added
+    mutable std::mutex _mutex;
+    List<String> _payloads; // Received and not decoded yet
+    List<String> _outgoing; // Frames queued for sending
+    size_t _num_sending; // Frames taken from the queue by the thread and not sent yet
+    std::atomic<bool> _terminate;
+    shared_ptr<Thread> _thread; // Created once listening
+};
+
+//! \brief Wraps an exploration, exchanging the best points with other islands through a channel
+//! \details Every \a migration_interval steps, the best \a num_migrants scores are sent to the peers. At each step,
+//! the scores received replace the worst local scores they improve upon, before the wrapped exploration is applied.
+//! Clones share the channel.
+class IslandExploration : public ExplorationInterface {
+  public:
+    IslandExploration(ExplorationInterface const& exploration, shared_ptr<IslandChannel> const& channel,
+                      size_t migration_interval = 1, size_t num_migrants = 1);
+
+    Set<ConfigurationSearchPoint> next_points_from(List<PointScore> const& scores) override;
+    Set<ConfigurationSearchPoint> contextualise(List<double> const& features, Set<ConfigurationSearchPoint> const& points) override;
+    void set_seed(std::uint64_t seed) override;
+    void save_state(BinaryWriter& writer) const override;
+    void load_state(BinaryReader& reader, ConfigurationSearchSpace const& space) override;
+    ExplorationInterface* clone() const override;
+
+    shared_ptr<IslandChannel> const& channel() const;
+    //! \brief The number of received scores that entered the population
+    size_t num_immigrants() const;
+
+  private:
+    shared_ptr<ExplorationInterface> _exploration;
+    shared_ptr<IslandChannel> _channel;
+    size_t _migration_interval;
+    size_t _num_migrants;
+    size_t _steps;
+    size_t _num_immigrants;
+};
+
+} // namespace pExplore
+
+#endif // PEXPLORE_HAS_ISLANDS
+
+#endif // PEXPLORE_ISLAND_HPP
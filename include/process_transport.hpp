@@ -0,0 +1,71 @@
+/***************************************************************************
+ *            process_transport.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/*! \file process_transport.hpp
+ *  \brief Traits for transferring task inputs and outputs between processes.
+ */
+
+#ifndef PEXPLORE_PROCESS_TRANSPORT_HPP
+#define PEXPLORE_PROCESS_TRANSPORT_HPP
+
+#include <concepts>
+#include <cstring>
+#include <type_traits>
+
+namespace pExplore {
+
+using std::size_t;
+
+//! \brief Transfers objects of type \a T across processes as raw bytes
+//! \details Specialise with size(value), the number of bytes for \a value, write(value,data), writing such bytes
+//! into \a data, and read(data,size), constructing back the value from \a size bytes in \a data. The data is not aligned.
+template<class T> struct ProcessTransport;
+
+//! \brief Trivially copyable objects are transferred as their own bytes, with no serialisation
+template<class T> requires std::is_trivially_copyable_v<T> and std::is_default_constructible_v<T>
+struct ProcessTransport<T> {
+    static size_t size(T const&) { return sizeof(T); }
+    static void write(T const& value, unsigned char* data) { std::memcpy(data,&value,sizeof(T)); }
+    static T read(unsigned char const* data, size_t) {
+        T result;
+        std::memcpy(&result,data,sizeof(T));
+        return result;
+    }
+};
+
+//! \brief Whether objects of type \a T can be transferred across processes
+template<class T> concept ProcessTransportable = requires(T const& value, unsigned char* data, unsigned char const* const_data, size_t size) {
+    { ProcessTransport<T>::size(value) } -> std::same_as<size_t>;
+    { ProcessTransport<T>::write(value,data) } -> std::same_as<void>;
+    { ProcessTransport<T>::read(const_data,size) } -> std::same_as<T>;
+};
+
+} // namespace pExplore
+
+#endif // PEXPLORE_PROCESS_TRANSPORT_HPP
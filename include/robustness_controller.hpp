@@ -34,9 +34,12 @@
 #define PEXPLORE_ROBUSTNESS_CONTROLLER
 
 #include <functional>
+#include "helper/container.hpp"
 
 namespace pExplore {
 
+using Helper::List;
+
 template<class R> struct TaskInput;
 template<class R> struct TaskOutput;
 
@@ -46,6 +49,11 @@ template<class R> class RobustnessControllerInterface {
     //! \details The application may change the state of the controller if \a update == true, this is why the method is not const
     virtual double apply(double robustness, TaskInput<R> const& input, TaskOutput<R> const& output, bool update) = 0;
 
+    //! \brief The internal state of the controller, for checkpointing
+    virtual List<double> state() const { return List<double>(); }
+    //! \brief Restore the internal \a state of the controller, as returned by state()
+    virtual void set_state(List<double> const&) { }
+
     virtual RobustnessControllerInterface<R>* clone() const = 0;
     virtual ~RobustnessControllerInterface() = default;
 };
@@ -62,7 +70,7 @@ template<class R> class TimeProgressLinearRobustnessController : public Robustne
   public:
     typedef std::function<double(TaskInput<R> const&, TaskOutput<R> const&)> TimeFunction;
 
-    TimeProgressLinearRobustnessController(TimeFunction func, double final_time) : _t_func(func), _final_time(final_time), _accumulated_value(0.0) { }
+    TimeProgressLinearRobustnessController(TimeFunction func, double final_time) : _t_func(func), _final_time(final_time), _previous_time(0.0), _accumulated_value(0.0) { }
 
     double apply(double robustness, TaskInput<R> const& input, TaskOutput<R> const& output, bool update) override {
         double current_time = _t_func(input,output);
@@ -73,6 +81,8 @@ template<class R> class TimeProgressLinearRobustnessController : public Robustne
         }
         return result;
     }
+    List<double> state() const override { return {_previous_time,_accumulated_value}; }
+    void set_state(List<double> const& state) override { _previous_time = state.at(0); _accumulated_value = state.at(1); }
     RobustnessControllerInterface<R>* clone() const override { return new TimeProgressLinearRobustnessController(_t_func,_final_time); }
 
   private:
@@ -42,6 +42,7 @@ namespace pExplore {
 using ProNest::ConfigurationSearchPoint;
 using Helper::WritableInterface;
 using Helper::Set;
+using Helper::List;
 using std::to_string;
 using std::ostream;
 using std::size_t;
@@ -57,6 +58,9 @@ class Score : public WritableInterface {
 
     double objective() const;
 
+    //! \brief The score with \a cost added to the objective
+    Score with_cost(double cost) const;
+
     //! \brief Ordering is minimum over hard_failures, then soft_failures, then objective
     //! \details Successes are not used
     bool operator<(Score const& e) const;
@@ -90,6 +94,13 @@ class PointScore : public WritableInterface {
     Score _score;
 };
 
+//! \brief The index of the best score in \a scores, which must not be empty
+size_t best_score_index(List<PointScore> const& scores);
+
+//! \brief The indices of the \a k best scores in \a scores, in no particular order
+//! \details Uses partial selection, so that the remaining scores are not ordered
+List<size_t> best_score_indices(List<PointScore> const& scores, size_t k);
+
 } // namespace pExplore
 
 #endif // PEXPLORE_SCORE
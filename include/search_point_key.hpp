@@ -0,0 +1,114 @@
+/***************************************************************************
+ *            search_point_key.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file search_point_key.hpp
+ *  \brief Classes for compact integer keys of search points.
+ */
+
+#ifndef PEXPLORE_SEARCH_POINT_KEY_HPP
+#define PEXPLORE_SEARCH_POINT_KEY_HPP
+
+#include <cstdint>
+#include "helper/container.hpp"
+#include "pronest/configuration_search_point.hpp"
+#include "pronest/configuration_search_space.hpp"
+
+namespace pExplore {
+
+using Helper::List;
+using ProNest::ConfigurationSearchPoint;
+using ProNest::ConfigurationSearchSpace;
+using std::size_t;
+
+typedef std::uint64_t SearchPointKey;
+
+//! \brief Encoder of the points of a search space into integer keys
+//! \details If the product of the ranges of the parameters fits into a key, the encoding is mixed-radix
+//! and hence exact, otherwise the key is a hash of the coordinates
+class SearchPointEncoder {
+  public:
+    SearchPointEncoder(ConfigurationSearchSpace const& space);
+
+    //! \brief The space of the points
+    ConfigurationSearchSpace const& space() const;
+
+    //! \brief Whether two different points always have different keys
+    bool is_exact() const;
+
+    //! \brief The key for \a point
+    SearchPointKey encode(ConfigurationSearchPoint const& point) const;
+    //! \brief The key for the \a coordinates of a point
+    SearchPointKey encode(List<int> const& coordinates) const;
+
+    //! \brief The point for the \a key
+    //! \details Requires the encoding to be exact
+    ConfigurationSearchPoint decode(SearchPointKey key) const;
+
+  private:
+    ConfigurationSearchSpace _space;
+    List<int> _offsets;
+    List<SearchPointKey> _radices;
+    bool _exact;
+};
+
+//! \brief The point in \a space with the given \a coordinates
+ConfigurationSearchPoint make_point_from_coordinates(ConfigurationSearchSpace const& space, List<int> const& coordinates);
+
+//! \brief A set of keys using open addressing with linear probing
+class SearchPointKeySet {
+  public:
+    SearchPointKeySet(size_t expected_size = 16);
+
+    //! \brief Insert \a key, returning whether it was not already present
+    bool insert(SearchPointKey key);
+    //! \brief Whether \a key is present
+    bool contains(SearchPointKey key) const;
+
+    size_t size() const;
+    bool empty() const;
+    //! \brief Remove all keys, preserving the allocated capacity
+    void clear();
+
+    //! \brief The keys present, in no particular order
+    List<SearchPointKey> keys() const;
+
+  private:
+    size_t _slot_for(SearchPointKey key) const;
+    void _grow();
+  private:
+    List<SearchPointKey> _keys;
+    List<unsigned char> _occupied;
+    size_t _size;
+};
+
+//! \brief A mixing function for keys, with good avalanche properties
+SearchPointKey mix_key(SearchPointKey key);
+
+} // namespace pExplore
+
+#endif // PEXPLORE_SEARCH_POINT_KEY_HPP
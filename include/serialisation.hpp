@@ -0,0 +1,122 @@
+/***************************************************************************
+ *            serialisation.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file serialisation.hpp
+ *  \brief Classes for compact binary serialisation of state.
+ */
+
+#ifndef PEXPLORE_SERIALISATION_HPP
+#define PEXPLORE_SERIALISATION_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include "helper/container.hpp"
+#include "helper/string.hpp"
+#include "pronest/configuration_search_point.hpp"
+#include "pronest/configuration_search_space.hpp"
+#include "score.hpp"
+#include "shifting.hpp"
+
+namespace pExplore {
+
+using Helper::List;
+using Helper::String;
+using ProNest::ConfigurationSearchPoint;
+using ProNest::ConfigurationSearchSpace;
+using std::size_t;
+
+//! \brief Exception for data that cannot be deserialised
+struct DeserialisationException : public std::runtime_error {
+    DeserialisationException(String const& what) : std::runtime_error(what) { }
+};
+
+//! \brief Writer of values into a binary string
+//! \details Values are written in the native byte order, hence data is meant to be read on the same architecture
+class BinaryWriter {
+  public:
+    template<class T> requires std::is_arithmetic_v<T> void write(T value) {
+        _data.append(reinterpret_cast<char const*>(&value),sizeof(T));
+    }
+    void write(String const& value);
+    void write(List<int> const& values);
+    void write(List<double> const& values);
+    void write(List<size_t> const& values);
+
+    String const& data() const;
+  private:
+    String _data;
+};
+
+//! \brief Reader of values from a binary string produced by BinaryWriter
+//! \details Throws DeserialisationException if the data is exhausted
+class BinaryReader {
+  public:
+    BinaryReader(String const& data);
+
+    template<class T> requires std::is_arithmetic_v<T> T read() {
+        _require(sizeof(T));
+        T result;
+        std::memcpy(&result,_data.data()+_position,sizeof(T));
+        _position += sizeof(T);
+        return result;
+    }
+    String read_string();
+    List<int> read_ints();
+    List<double> read_doubles();
+    List<size_t> read_sizes();
+
+    //! \brief Whether all data has been read
+    bool at_end() const;
+  private:
+    void _require(size_t num_bytes) const;
+    //! \brief Require \a num_items of \a item_size bytes each, without overflowing
+    void _require(size_t num_items, size_t item_size) const;
+  private:
+    String _data;
+    size_t _position;
+};
+
+//! \brief Write the coordinates of \a point
+void write_point(BinaryWriter& writer, ConfigurationSearchPoint const& point);
+//! \brief Read a point of \a space as written by write_point
+//! \details Throws DeserialisationException if the dimension does not match or a coordinate is not a value of its parameter
+ConfigurationSearchPoint read_point(BinaryReader& reader, ConfigurationSearchSpace const& space);
+
+void write_point_score(BinaryWriter& writer, PointScore const& point_score);
+PointScore read_point_score(BinaryReader& reader, ConfigurationSearchSpace const& space);
+
+//! \brief Write the state of \a generator
+void write_generator(BinaryWriter& writer, RandomGenerator const& generator);
+//! \brief Read into \a generator the state written by write_generator
+void read_generator(BinaryReader& reader, RandomGenerator& generator);
+
+} // namespace pExplore
+
+#endif // PEXPLORE_SERIALISATION_HPP
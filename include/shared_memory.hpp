@@ -0,0 +1,122 @@
+/***************************************************************************
+ *            shared_memory.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/*! \file shared_memory.hpp
+ *  \brief Classes for exchanging data with child processes through shared memory.
+ */
+
+#ifndef PEXPLORE_SHARED_MEMORY_HPP
+#define PEXPLORE_SHARED_MEMORY_HPP
+
+#if defined(__linux__)
+//! \brief Defined when worker processes can be used to run tasks
+#define PEXPLORE_HAS_PROCESS_ISOLATION
+#endif
+
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+
+#include <cstdint>
+#include <functional>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace pExplore {
+
+using std::size_t;
+
+//! \brief A region of memory shared with the child processes forked after its creation
+class SharedMemoryRegion {
+  public:
+    SharedMemoryRegion(size_t size);
+    SharedMemoryRegion(SharedMemoryRegion const&) = delete;
+    void operator=(SharedMemoryRegion const&) = delete;
+    ~SharedMemoryRegion();
+
+    unsigned char* data() const;
+    size_t size() const;
+  private:
+    unsigned char* _data;
+    size_t _size;
+};
+
+//! \brief A ring of fixed-capacity slots in shared memory, with one producer process and one consumer process
+//! \details Data is written into and read from the slots in place. Since a slot is published only by end_push(),
+//! a producer terminating abruptly never leaves a partially written slot visible to the consumer.
+class SharedRingBuffer {
+  public:
+    SharedRingBuffer(size_t num_slots, size_t slot_capacity);
+    SharedRingBuffer(SharedRingBuffer const&) = delete;
+    void operator=(SharedRingBuffer const&) = delete;
+    ~SharedRingBuffer();
+
+    size_t num_slots() const;
+    size_t slot_capacity() const;
+
+    //! \brief Wait for a free slot, returning its data area of slot_capacity() bytes, aligned as std::max_align_t
+    unsigned char* begin_push();
+    //! \brief Publish the slot from begin_push() with \a size bytes of data
+    void end_push(size_t size);
+
+    //! \brief Wait for a published slot for at most \a timeout_ms milliseconds, or indefinitely if negative
+    //! \details Returns the data of the slot and sets \a size, or returns nullptr on timeout
+    unsigned char const* begin_pull(size_t& size, long timeout_ms);
+    //! \brief Release the slot from begin_pull()
+    void end_pull();
+
+    //! \brief Empty the ring, when neither producer nor consumer are using it
+    void reset();
+
+  private:
+    struct Header;
+    Header& _header() const;
+    unsigned char* _slot(std::uint64_t index) const;
+  private:
+    size_t _num_slots;
+    size_t _slot_capacity;
+    SharedMemoryRegion _region;
+};
+
+//! \brief Fork a child process that runs \a body and exits with its result, returning the process identifier
+//! \details The child exits without unwinding the stack or running exit handlers of the parent
+pid_t fork_process(std::function<int()> const& body);
+//! \brief Whether the child process \a pid has terminated, in which case it is reaped
+bool has_terminated(pid_t pid);
+//! \brief Wait for the child process \a pid to terminate
+void wait_process(pid_t pid);
+//! \brief Wait for the child process \a pid for at most \a timeout_ms milliseconds, then kill it
+//! \return Whether the process terminated by itself
+bool wait_process(pid_t pid, long timeout_ms);
+//! \brief Wait for the child process \a pid for at most \a timeout_ms milliseconds, then kill it
+void terminate_process(pid_t pid, long timeout_ms);
+
+} // namespace pExplore
+
+#endif // PEXPLORE_HAS_PROCESS_ISOLATION
+
+#endif // PEXPLORE_SHARED_MEMORY_HPP
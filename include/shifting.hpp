@@ -0,0 +1,69 @@
+/***************************************************************************
+ *            shifting.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/*! \file shifting.hpp
+ *  \brief Functions for shifting search points using a given random generator.
+ */
+
+#ifndef PEXPLORE_SHIFTING_HPP
+#define PEXPLORE_SHIFTING_HPP
+
+#include <cstdint>
+#include <random>
+#include "helper/container.hpp"
+#include "pronest/configuration_search_point.hpp"
+
+namespace pExplore {
+
+using Helper::Set;
+using ProNest::ConfigurationSearchPoint;
+using std::size_t;
+
+//! \brief The generator for all stochastic choices in the exploration
+typedef std::mt19937_64 RandomGenerator;
+
+//! \brief Make a seed from the non-deterministic source of the system
+std::uint64_t make_random_seed();
+
+//! \brief Derive the seed of an independent stream with index \a stream from \a seed
+std::uint64_t derive_seed(std::uint64_t seed, std::uint64_t stream);
+
+//! \brief Make a point by \a distance unit shifts from \a point, each on a random parameter
+//! \details Metric parameters move to an adjacent value, other parameters to any other value
+ConfigurationSearchPoint make_shifted(ConfigurationSearchPoint const& point, size_t distance, RandomGenerator& generator);
+
+//! \brief Extend \a sources to \a size points, by shifting random points in the set
+//! \details The shift distance increases when new points become hard to find, hence the function terminates
+//! as long as \a size does not exceed the total points of the space. Unlike the ProNest function with the same name,
+//! the outcome depends only on the state of \a generator.
+Set<ConfigurationSearchPoint> make_extended_set_by_shifting(Set<ConfigurationSearchPoint> const& sources, size_t size, RandomGenerator& generator);
+
+} // namespace pExplore
+
+#endif // PEXPLORE_SHIFTING_HPP
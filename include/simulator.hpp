@@ -0,0 +1,99 @@
+/***************************************************************************
+ *            simulator.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/*! \file simulator.hpp
+ *  \brief Classes for simulating a parameter search offline, from a recorded execution trace.
+ */
+
+#ifndef PEXPLORE_SIMULATOR_HPP
+#define PEXPLORE_SIMULATOR_HPP
+
+#include <cstdint>
+#include "helper/container.hpp"
+#include "helper/writable.hpp"
+#include "pronest/configuration_search_point.hpp"
+#include "exploration.hpp"
+#include "initialisation.hpp"
+#include "score.hpp"
+#include "trace.hpp"
+
+namespace pExplore {
+
+using Helper::List;
+using Helper::WritableInterface;
+using ProNest::ConfigurationSearchPoint;
+using std::shared_ptr;
+
+//! \brief The outcome of a simulated parameter search, with times on the virtual clock in seconds
+struct SimulationReport : public WritableInterface {
+    SimulationReport(PointScore const& best_, double time_to_best_, size_t steps_to_best_, double total_time_, double utilisation_,
+                     List<double> const& step_end_times_, List<PointScore> const& step_best_scores_)
+        : best(best_), time_to_best(time_to_best_), steps_to_best(steps_to_best_), total_time(total_time_), utilisation(utilisation_),
+          step_end_times(step_end_times_), step_best_scores(step_best_scores_) { }
+    //! \brief The best point score found
+    PointScore best;
+    //! \brief The time at the end of the step where the best point score was first found
+    double time_to_best;
+    size_t steps_to_best;
+    double total_time;
+    //! \brief The fraction of the available core time spent running tasks
+    double utilisation;
+    List<double> step_end_times;
+    List<PointScore> step_best_scores;
+
+    ostream& _write(ostream& os) const override;
+};
+
+//! \brief Simulates a parameter search by replaying the latencies and scores of a trace through an exploration
+//! \details Each step runs as many tasks as the concurrency on \a num_cores cores, assigning each task to the earliest
+//! available core, and ends when all its tasks have completed, as for ParameterSearchRunner. Points absent from the trace
+//! take the outcome of the nearest recorded point.
+class ExplorationSimulator {
+  public:
+    ExplorationSimulator(ExecutionTrace const& trace, ExplorationInterface const& exploration,
+                         InitialisationInterface const& initialisation, size_t num_cores);
+
+    //! \brief Seed the exploration and initialisation, so that simulations are reproducible
+    void set_seed(std::uint64_t seed);
+
+    //! \brief Simulate \a num_steps steps starting from \a initial_point, evaluating \a concurrency points per step
+    //! \details Each simulation starts from fresh clones of the exploration and initialisation
+    SimulationReport run(ConfigurationSearchPoint const& initial_point, size_t concurrency, size_t num_steps) const;
+
+  private:
+    ExecutionTrace _trace;
+    shared_ptr<ExplorationInterface> _exploration;
+    shared_ptr<InitialisationInterface> _initialisation;
+    size_t _num_cores;
+    std::uint64_t _seed;
+};
+
+} // namespace pExplore
+
+#endif // PEXPLORE_SIMULATOR_HPP
@@ -0,0 +1,187 @@
+/***************************************************************************
+ *            static_constraint.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file static_constraint.hpp
+ *  \brief Classes for constraints whose kind, impact and controller are known at compile time.
+ */
+
+#ifndef PEXPLORE_STATIC_CONSTRAINT_HPP
+#define PEXPLORE_STATIC_CONSTRAINT_HPP
+
+#include <cmath>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include "helper/container.hpp"
+#include "helper/macros.hpp"
+#include "helper/string.hpp"
+#include "constraint.hpp"
+#include "constraining_state.hpp"
+#include "score.hpp"
+
+namespace pExplore {
+
+using Helper::Set;
+using Helper::List;
+using Helper::String;
+
+//! \brief A constraint in the input \a in and output \a out objects of the task, with \a K failure kind and \a I objective impact
+//! \details The constraint is expressed as f(in,out) > 0 as for Constraint, but the function \a F is stored by value and the
+//! controller is known to be a \a CTRL, so that evaluation within a StaticConstraintSet involves no indirect call
+template<class R, ConstraintFailureKind K, ConstraintObjectiveImpact I, class F, class CTRL = IdentityRobustnessController<R>>
+class StaticConstraint {
+    static_assert(std::is_base_of_v<RobustnessControllerInterface<R>,CTRL>, "The controller of a static constraint must be a robustness controller.");
+  public:
+    typedef TaskInput<R> InputType;
+    typedef TaskOutput<R> OutputType;
+    typedef R RunnableType;
+    typedef CTRL ControllerType;
+
+    StaticConstraint(F const& func, CTRL const& controller = CTRL()) : _func(func), _controller(controller), _name(std::string()), _group_id(0), _success_action(ConstraintSuccessAction::NONE) { }
+
+    StaticConstraint& set_name(String name) { _name = name; return *this; }
+    StaticConstraint& set_group_id(size_t group_id) { _group_id = group_id; return *this; }
+    StaticConstraint& set_success_action(ConstraintSuccessAction const& success_action) { _success_action = success_action; return *this; }
+
+    static constexpr ConstraintFailureKind failure_kind() { return K; }
+    static constexpr ConstraintObjectiveImpact objective_impact() { return I; }
+
+    //! \brief The value of the constraint function given an \a input and \a output, before control
+    double value(InputType const& input, OutputType const& output) const { return _func(input, output); }
+
+    //! \brief The equivalent constraint, with its own copy of the controller
+    Constraint<R> constraint() const {
+        return ConstraintBuilder<R>(_func).set_name(_name).set_group_id(_group_id).set_success_action(_success_action)
+                .set_failure_kind(K).set_objective_impact(I).set_controller(_controller).build();
+    }
+
+  private:
+    F _func;
+    CTRL _controller;
+    String _name;
+    size_t _group_id;
+    ConstraintSuccessAction _success_action;
+};
+
+//! \brief Make a static constraint for runnable \a R from \a func, deducing the function type
+template<class R, ConstraintFailureKind K, ConstraintObjectiveImpact I, class F>
+StaticConstraint<R,K,I,F> make_static_constraint(F const& func) {
+    return {func};
+}
+
+//! \brief Make a static constraint for runnable \a R from \a func and \a controller, deducing their types
+template<class R, ConstraintFailureKind K, ConstraintObjectiveImpact I, class F, class CTRL>
+StaticConstraint<R,K,I,F,CTRL> make_static_constraint(F const& func, CTRL const& controller) {
+    return {func,controller};
+}
+
+//! \brief A fixed set of static constraints, evaluated in one unrolled pass
+//! \details The set is used through constraining_state(), whose scores are the same as for the equivalent constraints
+//! evaluated one by one, with indices referring to the position of the constraint in the set
+template<class... CS> class StaticConstraintSet : public ConstraintSetEvaluatorInterface<typename std::tuple_element_t<0,std::tuple<CS...>>::RunnableType> {
+    static_assert(sizeof...(CS) > 0, "A static constraint set requires at least one constraint.");
+    typedef std::tuple_element_t<0,std::tuple<CS...>> FirstConstraintType;
+  public:
+    typedef typename FirstConstraintType::RunnableType RunnableType;
+    typedef TaskInput<RunnableType> InputType;
+    typedef TaskOutput<RunnableType> OutputType;
+
+    static_assert((std::is_same_v<typename CS::RunnableType,RunnableType> and ...), "All static constraints must refer to the same runnable.");
+
+    StaticConstraintSet(CS const&... constraints) : _constraints(constraints...) { }
+
+    static constexpr size_t size() { return sizeof...(CS); }
+
+    //! \brief The equivalent constraints, in the same order
+    List<Constraint<RunnableType>> constraints() const {
+        return std::apply([](CS const&... cs) { return List<Constraint<RunnableType>>({cs.constraint()...}); }, _constraints);
+    }
+
+    //! \brief A constraining state for the equivalent constraints, evaluated by this set
+    ConstrainingState<RunnableType> constraining_state() const {
+        return {constraints(), std::make_shared<StaticConstraintSet<CS...>>(*this)};
+    }
+
+    bool is_compatible_with(List<Constraint<RunnableType>> const& constraints) const override {
+        if (constraints.size() != size()) return false;
+        return _are_compatible(constraints,std::index_sequence_for<CS...>());
+    }
+
+    Score evaluate(List<ConstraintState<RunnableType>> const& states, InputType const& input, OutputType const& output, bool update_controller) const override {
+        HELPER_PRECONDITION(states.size() == size())
+        double objective = 0.0;
+        Set<size_t> successes;
+        Set<size_t> hard_failures;
+        Set<size_t> soft_failures;
+        _evaluate_all(states,input,output,update_controller,objective,successes,hard_failures,soft_failures,std::index_sequence_for<CS...>());
+        return {successes, hard_failures, soft_failures, objective};
+    }
+
+  private:
+
+    template<size_t... IDX> bool _are_compatible(List<Constraint<RunnableType>> const& constraints, std::index_sequence<IDX...>) const {
+        return (_is_compatible<IDX>(constraints.at(IDX)) and ...);
+    }
+
+    template<size_t IDX> bool _is_compatible(Constraint<RunnableType> const& c) const {
+        typedef std::tuple_element_t<IDX,std::tuple<CS...>> ConstraintType;
+        // The exact type is required, since the controller is applied by a qualified call that would skip any override
+        return c.failure_kind() == ConstraintType::failure_kind() and c.objective_impact() == ConstraintType::objective_impact() and
+               typeid(c.controller()) == typeid(typename ConstraintType::ControllerType);
+    }
+
+    template<size_t... IDX> void _evaluate_all(List<ConstraintState<RunnableType>> const& states, InputType const& input, OutputType const& output, bool update_controller, double& objective,
+                                                Set<size_t>& successes, Set<size_t>& hard_failures, Set<size_t>& soft_failures, std::index_sequence<IDX...>) const {
+        (_evaluate_one<IDX>(states[IDX],input,output,update_controller,objective,successes,hard_failures,soft_failures), ...);
+    }
+
+    template<size_t IDX> void _evaluate_one(ConstraintState<RunnableType> const& state, InputType const& input, OutputType const& output, bool update_controller, double& objective,
+                                             Set<size_t>& successes, Set<size_t>& hard_failures, Set<size_t>& soft_failures) const {
+        if (not state.is_active()) return;
+        typedef std::tuple_element_t<IDX,std::tuple<CS...>> ConstraintType;
+        auto value = std::get<IDX>(_constraints).value(input,output);
+        auto robustness = state.constraint().template controlled_robustness<typename ConstraintType::ControllerType>(value,input,output,update_controller);
+        if constexpr (ConstraintType::objective_impact() == ConstraintObjectiveImpact::UNSIGNED) objective += std::abs(robustness);
+        else if constexpr (ConstraintType::objective_impact() == ConstraintObjectiveImpact::SIGNED) objective += robustness;
+        if (robustness < 0) {
+            if constexpr (ConstraintType::failure_kind() == ConstraintFailureKind::HARD) hard_failures.insert(IDX);
+            else if constexpr (ConstraintType::failure_kind() == ConstraintFailureKind::SOFT) soft_failures.insert(IDX);
+        } else {
+            successes.insert(IDX);
+        }
+    }
+
+  private:
+    std::tuple<CS...> _constraints;
+};
+
+} // namespace pExplore
+
+#endif // PEXPLORE_STATIC_CONSTRAINT_HPP
@@ -60,6 +60,7 @@ class ParameterSearchTaskBase : public TaskInterface<R> {
     String name() const override { return _name; }
     ConstrainingState<R> const& constraining_state() const override { return _constraining_state; }
     void set_constraints(List<Constraint<R>> const& constraints) override { _constraining_state = ConstrainingState<R>(constraints); }
+    void set_constraining_state(ConstrainingState<R> const& state) override { _constraining_state = ConstrainingState<R>(state); }
     void update_constraining_state(InputType const& input, OutputType const& output) override { _constraining_state.update_from(input, output); }
 
   private:
@@ -34,6 +34,7 @@
 #define PEXPLORE_TASK_INTERFACE_HPP
 
 #include <chrono>
+#include <span>
 #include "helper/container.hpp"
 #include "helper/tuple.hpp"
 #include "helper/string.hpp"
@@ -52,6 +53,7 @@ using ProNest::Configuration;
 class PointScore;
 template<class R> class Constraint;
 template<class R> class ConstrainingState;
+template<class... CS> class StaticConstraintSet;
 
 template<class R> struct TaskInput;
 template<class R> struct TaskOutput;
@@ -70,11 +72,32 @@ class TaskInterface {
     virtual ConstrainingState<R> const& constraining_state() const = 0;
     //! \brief Set the constraints for the task
     virtual void set_constraints(List<Constraint<R>> const& constraints) = 0;
+    //! \brief Replace the constraining state, e.g., when restoring from a checkpoint
+    virtual void set_constraining_state(ConstrainingState<R> const& state) = 0;
     //! \brief Update the constraining state given the \a input and \a output
     virtual void update_constraining_state(InputType const& input, OutputType const& output) = 0;
+    //! \brief Features of the \a input that characterise the context for choosing a point
+    //! \details The default returns no features, i.e., the choice does not depend on the input
+    virtual List<double> context_features(InputType const&) const { return List<double>(); }
 
     //! \brief The task to be performed, taking \a in as input and \a cfg as a configuration of the parameters
     virtual OutputType run(InputType const& in, ConfigurationType const& cfg) const = 0;
+
+    //! \brief The task to be performed at a reduced \a fidelity in (0,1), used for screening configurations
+    //! \details The default ignores the fidelity; a task with a natural fidelity knob (e.g., a shorter time horizon) should override it
+    virtual OutputType run_at_fidelity(InputType const& in, ConfigurationType const& cfg, double) const { return run(in,cfg); }
+
+    //! \brief The task performed on \a in for each configuration of \a cfgs at once, returning the outputs in the same order
+    //! \details The default runs each configuration in turn; a task that shares work between configurations should override it,
+    //! along with max_batch_size(). The configurations are referred to, since they are shared with the cache of the runner.
+    virtual List<OutputType> run_batch(InputType const& in, std::span<ConfigurationType const* const> cfgs) const {
+        List<OutputType> result;
+        result.reserve(cfgs.size());
+        for (auto cfg : cfgs) result.push_back(run(in,*cfg));
+        return result;
+    }
+    //! \brief The maximum number of configurations to be given to run_batch, where 1 disables batching
+    virtual size_t max_batch_size() const { return 1; }
 };
 
 } // namespace pExplore
@@ -33,19 +33,29 @@
 #ifndef PEXPLORE_CONCURRENCY_MANAGER_HPP
 #define PEXPLORE_CONCURRENCY_MANAGER_HPP
 
+#include <chrono>
 #include <thread>
 #include <algorithm>
+#include <optional>
+#include <typeinfo>
 #include "pronest/configuration_property_path.hpp"
 #include "conclog/logging.hpp"
 #include "helper/container.hpp"
+#include "concurrency.hpp"
 #include "task_runner.hpp"
 #include "score.hpp"
+#include "warm_start.hpp"
 
 namespace pExplore {
 
 using ProNest::ConfigurationPropertyPath;
 using ConcLog::Logger;
 
+//! \brief Where the tasks of a parameter search are run
+//! \details THREAD runs them in the threads of the application, PROCESS in pre-forked worker processes,
+//! FORK in a process forked for each task, which shares the memory of the application copy-on-write
+enum class RunnerIsolation { THREAD, PROCESS, FORK };
+
 //! \brief Manages threads and sets runners based on concurrency availability.
 class TaskManager {
   private:
@@ -73,29 +83,105 @@ class TaskManager {
     }
 
     //! \brief Choose the proper runner for \a runnable
+    //! \details The current runner is kept if it would be chosen again, with the constraints replaced and the search continued
     template<class T> void choose_runner_for(TaskRunnable<T>& runnable, List<Constraint<T>> const& constraints, ConfigurationSearchPoint const& initial_point) const {
-        HELPER_PRECONDITION(not constraints.empty())
-        auto concurrency = BetterThreads::ThreadManager::instance().concurrency();
+        choose_runner_for(runnable,ConstrainingState<T>(constraints),initial_point);
+    }
+
+    //! \brief Choose the proper runner for \a runnable, whose task takes the constraints of \a constraining_state
+    //! \details The current runner is kept if it would be chosen again, with the constraints replaced and the search restarted
+    //! from \a initial_point, keeping the state of the exploration
+    template<class T> void choose_runner_for(TaskRunnable<T>& runnable, ConstrainingState<T> const& constraining_state, ConfigurationSearchPoint const& initial_point) const {
+        HELPER_PRECONDITION(not constraining_state.states().empty())
+        if (_can_keep_runner(runnable)) {
+            runnable.runner()->task().set_constraining_state(constraining_state);
+            _reconfigure_kept_runner(runnable,initial_point);
+            return;
+        }
+        auto concurrency = search_concurrency();
         std::shared_ptr<TaskRunnerInterface<T>> runner;
         auto const& cfg = runnable.configuration();
         if (concurrency > 1 and not cfg.is_singleton()) {
-            runner.reset(new ParameterSearchRunner<T>(cfg,*_exploration,initial_point,std::min(concurrency,cfg.search_space().total_points())));
+            runner = _make_search_runner<T>(cfg,initial_point,std::min(concurrency,cfg.search_space().total_points()));
         } else if (not cfg.is_singleton()) {
             CONCLOG_PRINTLN_AT(1,"The configuration is not singleton: using initial point " << initial_point << " for sequential running.");
             runner.reset(new SequentialRunner<T>(make_singleton(cfg,initial_point)));
         } else
             runner.reset(new SequentialRunner<T>(cfg));
 
-        runner->task().set_constraints(constraints);
+        runner->task().set_constraining_state(constraining_state);
         runnable.set_runner(runner);
     }
 
+    //! \brief Choose the proper runner for \a runnable starting from \a initial_point, with the current constraints
+    //! \details The current runner is kept if it would be chosen again, with the search restarted from \a initial_point
+    template<class T> void choose_runner_for(TaskRunnable<T>& runnable, ConfigurationSearchPoint const& initial_point) const {
+        if (not _can_keep_runner(runnable)) {
+            auto const& constraining_state = runnable.runner()->task().constraining_state();
+            choose_runner_for(runnable,ConstrainingState<T>(constraining_state.constraints(),constraining_state.evaluator()),initial_point);
+            return;
+        }
+        _reconfigure_kept_runner(runnable,initial_point);
+    }
+
+    //! \brief Set the concurrency of parameter searches, overriding the detected one
+    void set_concurrency_override(size_t concurrency);
+    void clear_concurrency_override();
+    //! \brief The concurrency of parameter searches
+    //! \details The override if set, otherwise the concurrency of the ThreadManager limited by the processors available to the process,
+    //! as detected by available_concurrency() each time a runner is chosen
+    size_t search_concurrency() const;
+
     void set_exploration(ExplorationInterface const& exploration);
+    //! \brief Set the strategy for the initial points of the exploration
+    void set_initialisation(InitialisationInterface const& initialisation);
+    //! \brief Set the schedule for screening points at lower fidelities before running at full fidelity
+    void set_fidelity_schedule(SuccessiveHalvingSchedule const& schedule);
+    //! \brief Set the file where parameter searches save a checkpoint after each step, empty to disable checkpointing
+    //! \details Applies to runners chosen afterwards; the state is serialised by each pull before returning, then written in a dedicated thread
+    void set_checkpoint_file(String const& filename);
+    String const& checkpoint_file() const;
+    //! \brief Set the seed for the stochastic choices of parameter searches, so that runs can be reproduced
+    //! \details Applies to runners chosen afterwards; without a seed, each runner draws one from the system
+    void set_seed(std::uint64_t seed);
+    void clear_seed();
+    //! \brief The point of \a space from which a parameter search starts when the constraints are set
+    //! \details Drawn from the seed if any, otherwise from the system as by the search space
+    ConfigurationSearchPoint initial_point(ConfigurationSearchSpace const& space) const;
+    //! \brief Record the decisions of parameter searches into \a filename, or replay them from it, depending on \a mode
+    //! \details Applies to runners chosen afterwards, each one restarting the log, hence it is meant for a single search
+    void set_decision_log(String const& filename, DecisionLog::Mode mode);
+    void clear_decision_log();
+    //! \brief Record the latency and score of each task run by parameter searches into \a filename, empty to disable tracing
+    //! \details Applies to runners chosen afterwards, each one restarting the trace; the trace can drive an ExplorationSimulator
+    void set_trace_file(String const& filename);
+    //! \brief Set whether parameter searches run their tasks in threads or in processes
+    //! \details Applies to runners chosen afterwards; processes are used only where supported and only for tasks whose
+    //! output, and also input for worker processes, are ProcessTransportable, otherwise threads are used
+    void set_isolation(RunnerIsolation isolation);
+    //! \brief Set the capacity in bytes of the shared memory slots for exchanging inputs and outputs with processes
+    void set_process_slot_capacity(size_t capacity);
+    //! \brief Set the time after which a process running a task is killed, counting as a task failure
+    //! \details Applies to the worker processes, which are forked again, and to the processes forked for each task
+    void set_process_task_timeout(std::chrono::milliseconds timeout);
+    //! \brief Set how the threads of parameter searches, or their worker processes, are pinned to processors
+    //! \details Applies to runners chosen afterwards, using the topology of the processors available to the process
+    void set_affinity(AffinityPolicy const& policy);
+    AffinityPolicy const& affinity() const;
+    //! \brief Set the wall-clock budget of each step of parameter searches, using real-time runners
+    //! \details Applies to runners chosen afterwards; see RealTimeRunner for the requirements on the task
+    void set_step_budget(std::chrono::microseconds budget);
+    void clear_step_budget();
+    //! \brief Set the \a weight of the running time of a task, added to the objective of its score for each second taken
+    //! \details Applies to runners chosen afterwards; with equal constraint satisfaction, faster configurations are then preferred.
+    //! Only the task is timed, excluding the transfer of inputs and outputs for processes and the scoring
+    void set_runtime_weight(double weight);
+    double runtime_weight() const;
 
     //! \brief The best scores saved
     List<PointScore> best_scores() const;
-    void append_scores(Set<PointScore> const& scores);
-    List<Set<PointScore>> const& scores() const;
+    void append_scores(List<PointScore> const& scores);
+    List<List<PointScore>> const& scores() const;
     void clear_scores();
 
     //! \brief Print best scores in a .m file for plotting
@@ -104,10 +190,84 @@ class TaskManager {
     //! \brief Return the optimal point (i.e., the most common value for all dimensions)
     List<int> optimal_point() const;
 
+    //! \brief Save the best scores into \a store under \a tag, to warm-start later runs
+    void save_warm_start(WarmStartStore const& store, String const& tag) const;
+
+  private:
+    std::shared_ptr<DecisionLog> _make_decision_log() const;
+    ParameterSearchSettings _search_settings(size_t concurrency) const;
+
+    //! \brief Whether the runner of \a runnable can be kept, i.e., it is of the kind that would be chosen now and,
+    //! for a parameter search, made with the current settings
+    template<class T> bool _can_keep_runner(TaskRunnable<T>& runnable) const {
+        auto runner = runnable.runner().get();
+        if (runnable.configuration().is_singleton()) return dynamic_cast<SequentialRunner<T>*>(runner) != nullptr;
+        auto search_runner = dynamic_cast<ParameterSearchRunner<T>*>(runner);
+        return search_concurrency() > 1 and search_runner != nullptr and search_runner->_settings_version == _settings_version and
+               _is_made_search_runner<T>(*search_runner);
+    }
+
+    //! \brief Apply the current concurrency and \a initial_point to the kept runner of \a runnable, if a parameter search
+    //! \details Both take effect at the next step of the search
+    template<class T> void _reconfigure_kept_runner(TaskRunnable<T>& runnable, ConfigurationSearchPoint const& initial_point) const {
+        auto search_runner = dynamic_cast<ParameterSearchRunner<T>*>(runnable.runner().get());
+        if (search_runner == nullptr) return;
+        search_runner->set_concurrency(search_concurrency());
+        search_runner->set_initial_point(initial_point);
+    }
+
+    //! \brief Whether \a runner has the class that _make_search_runner would choose now
+    template<class T> bool _is_made_search_runner(ParameterSearchRunner<T> const& runner) const {
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+        if constexpr (ProcessTransportable<TaskInput<T>> and ProcessTransportable<TaskOutput<T>>) {
+            if (_isolation == RunnerIsolation::PROCESS) return dynamic_cast<ProcessPoolRunner<T> const*>(&runner) != nullptr;
+        }
+        if constexpr (ProcessTransportable<TaskOutput<T>>) {
+            if (_isolation == RunnerIsolation::FORK) return dynamic_cast<ForkSnapshotRunner<T> const*>(&runner) != nullptr;
+        }
+#endif
+        return typeid(runner) == typeid(ParameterSearchRunner<T>);
+    }
+
+    template<class T> std::shared_ptr<TaskRunnerInterface<T>> _make_search_runner(Configuration<T> const& cfg, ConfigurationSearchPoint const& initial_point, size_t concurrency) const {
+        if (_step_budget.has_value()) {
+            if (_isolation != RunnerIsolation::THREAD)
+                CONCLOG_PRINTLN_AT(1,"Processes are not available for real-time runners: using threads.");
+            return std::shared_ptr<TaskRunnerInterface<T>>(new RealTimeRunner<T>(cfg,_search_settings(concurrency),initial_point,concurrency,_step_budget.value()));
+        }
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+        if constexpr (ProcessTransportable<TaskInput<T>> and ProcessTransportable<TaskOutput<T>>) {
+            if (_isolation == RunnerIsolation::PROCESS)
+                return std::shared_ptr<TaskRunnerInterface<T>>(new ProcessPoolRunner<T>(cfg,_search_settings(concurrency),initial_point,concurrency,_process_slot_capacity,_process_task_timeout));
+        }
+        if constexpr (ProcessTransportable<TaskOutput<T>>) {
+            if (_isolation == RunnerIsolation::FORK)
+                return std::shared_ptr<TaskRunnerInterface<T>>(new ForkSnapshotRunner<T>(cfg,_search_settings(concurrency),initial_point,concurrency,_process_slot_capacity,_process_task_timeout));
+        }
+#endif
+        if (_isolation != RunnerIsolation::THREAD)
+            CONCLOG_PRINTLN_AT(1,"Processes are not available for the task: using threads.");
+        return std::shared_ptr<TaskRunnerInterface<T>>(new ParameterSearchRunner<T>(cfg,_search_settings(concurrency),initial_point,concurrency));
+    }
   private:
     std::shared_ptr<ExplorationInterface> _exploration;
+    std::shared_ptr<InitialisationInterface> _initialisation;
+    SuccessiveHalvingSchedule _fidelity_schedule;
+    String _checkpoint_file;
+    std::optional<size_t> _concurrency_override;
+    std::optional<std::uint64_t> _seed;
+    String _decision_log_file;
+    DecisionLog::Mode _decision_log_mode;
+    String _trace_file;
+    RunnerIsolation _isolation;
+    size_t _process_slot_capacity;
+    std::chrono::milliseconds _process_task_timeout;
+    AffinityPolicy _affinity;
+    std::optional<std::chrono::microseconds> _step_budget;
+    double _runtime_weight;
+    size_t _settings_version; // Increased when the settings of parameter searches change
     std::mutex _data_mutex;
-    List<Set<PointScore>> _scores;
+    List<List<PointScore>> _scores;
 };
 
 } // namespace pExplore
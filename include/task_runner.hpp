@@ -33,6 +33,10 @@
 #ifndef PEXPLORE_TASK_RUNNER_HPP
 #define PEXPLORE_TASK_RUNNER_HPP
 
+#include <chrono>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
 #include "betterthreads/thread.hpp"
 #include "betterthreads/buffer.hpp"
 #include "pronest/configuration_search_point.hpp"
@@ -42,6 +46,17 @@
 #include "task_runner_interface.hpp"
 #include "score.hpp"
 #include "exploration.hpp"
+#include "fidelity.hpp"
+#include "initialisation.hpp"
+#include "search_point_key.hpp"
+#include "serialisation.hpp"
+#include "checkpoint.hpp"
+#include "decision_log.hpp"
+#include "shifting.hpp"
+#include "trace.hpp"
+#include "process_transport.hpp"
+#include "shared_memory.hpp"
+#include "affinity.hpp"
 
 namespace pExplore {
 
@@ -105,33 +120,138 @@ private:
 
 template<class O> class OutputPointScore;
 
+//! \brief The settings of a parameter search, as chosen by the TaskManager
+struct ParameterSearchSettings {
+    shared_ptr<ExplorationInterface> exploration; // Prototype, cloned by the runner
+    shared_ptr<InitialisationInterface> initialisation; // Prototype, cloned by the runner
+    SuccessiveHalvingSchedule schedule;
+    String checkpoint_file; // Empty for no checkpointing
+    std::uint64_t seed;
+    shared_ptr<DecisionLog> decision_log; // Null for no decision logging
+    shared_ptr<TraceRecorder> trace_recorder; // Null for no tracing
+    AffinityPolicy affinity; // How to place the threads, including those added when resizing
+    List<ProcessorLocation> topology; // Of the processors available, empty if not read or not available
+    size_t version; // Of the settings of the TaskManager, to tell whether the runner can be kept when reconfigured
+    double runtime_weight; // Added to the objective for each second taken by a task
+};
+
+//! \brief The singleton configurations at the points of a configuration, built once and then shared by the threads of a runner
+//! \details Points are cached only with an exact point encoder, the cache being restarted once full
+template<class C> class SingletonCache {
+    typedef Configuration<C> ConfigurationType;
+    //! \brief The maximum number of singleton configurations kept, after which the cache is restarted
+    static constexpr size_t CAPACITY = 4096;
+  public:
+    //! \brief Construct for the points of \a configuration, which must outlive the cache
+    SingletonCache(ConfigurationType const& configuration);
+    //! \brief The singleton configuration at \a point
+    //! \details Not to be used by forked processes, since another thread may hold the lock when forking
+    shared_ptr<ConfigurationType const> at(ConfigurationSearchPoint const& point);
+  private:
+    ConfigurationType const& _configuration;
+    SearchPointEncoder const _point_encoder;
+    std::mutex _mutex;
+    std::unordered_map<SearchPointKey,shared_ptr<ConfigurationType const>> _singletons;
+};
+
 //! \brief Run a task by detached concurrent search into the parameter space.
-template<class C> class ParameterSearchRunner final : public TaskRunnerBase<C> {
+template<class C> class ParameterSearchRunner : public TaskRunnerBase<C> {
     friend class TaskManager;
+  protected:
     typedef typename TaskRunnerBase<C>::InputType InputType;
     typedef typename TaskRunnerBase<C>::OutputType OutputType;
     typedef typename TaskRunnerBase<C>::ConfigurationType ConfigurationType;
-    typedef Pair<InputType,ConfigurationSearchPoint> InputBufferContentType;
+  private:
+    // The input is shared by all the tasks of a step, instead of being copied for each
+    typedef std::tuple<shared_ptr<InputType const>,List<ConfigurationSearchPoint>,double> InputBufferContentType;
     typedef OutputPointScore<C> OutputBufferContentType;
     typedef Buffer<InputBufferContentType> InputBufferType;
     typedef Buffer<OutputBufferContentType> OutputBufferType;
+    //! \brief Identifies a checkpoint of a parameter search, along with its format version
+    static constexpr std::uint32_t CHECKPOINT_MAGIC = 0x70457843;
+    static constexpr std::uint32_t CHECKPOINT_VERSION = 5;
   protected:
-    ParameterSearchRunner(ConfigurationType const& configuration, ExplorationInterface const& exploration, ConfigurationSearchPoint const& initial_point, size_t concurrency);
+    ParameterSearchRunner(ConfigurationType const& configuration, ParameterSearchSettings const& settings,
+                          ConfigurationSearchPoint const& initial_point, size_t concurrency);
   public:
     virtual ~ParameterSearchRunner();
 
     void push(InputType const& input) override final;
     OutputType pull() override final;
 
-private:
-    void _loop();
-private:
-    size_t const _concurrency; // Number of threads to be used
+    //! \brief Restore the state of the search from the checkpoint in \a filename
+    //! \details Throws DeserialisationException if the checkpoint does not match this runner
+    void restore(String const& filename);
+
+    //! \brief Restart the search from \a initial_point, keeping the constraining state and the state of the exploration
+    //! \details Takes effect at the next push, i.e., at a step boundary
+    void set_initial_point(ConfigurationSearchPoint const& initial_point);
+    //! \brief Change the number of threads, hence of points evaluated in each step, to \a concurrency
+    //! \details Takes effect at the next push, i.e., at a step boundary, keeping the constraining state and the state of the
+    //! exploration; the points of the next step are kept, then extended by shifting or truncated as needed
+    void set_concurrency(size_t concurrency);
+
+  protected:
+    //! \brief Start the threads, when the search becomes active
+    virtual void _activate();
+    //! \brief Run the task on \a input with the configuration at \a point and at \a fidelity, from the thread of index \a worker
+    //! \details Exceptions count as task failures. The \a latency is set to the seconds taken by the task only, excluding
+    //! the construction of the configuration and any communication with other processes.
+    virtual OutputType _execute(size_t worker, InputType const& input, ConfigurationSearchPoint const& point, double fidelity, double& latency);
+    //! \brief Run the task on \a input with the configuration \a cfg, at \a fidelity, setting \a latency to the seconds taken
+    OutputType _run(InputType const& input, ConfigurationType const& cfg, double fidelity, double& latency) const;
+    //! \brief Run the task on \a input with the configurations at \a points together, at full fidelity, setting \a latency to the seconds taken
+    List<OutputType> _execute_batch(InputType const& input, List<ConfigurationSearchPoint> const& points, double& latency);
+    //! \brief The maximum number of points to be given to one thread at full fidelity
+    //! \details Runners that do not execute tasks in their threads should disable batching
+    virtual size_t _max_batch_size() const;
+    //! \brief Change the concurrency to \a concurrency, with no task in progress
+    //! \details Runners with resources for each thread extend it to allocate or release them
+    virtual void _resize(size_t concurrency);
+    //! \brief Terminate the threads, waiting for the tasks in progress
+    void _stop();
+    size_t concurrency() const;
+    //! \brief Pin the calling thread or process to the processor of \a worker, if any, returning false on failure
+    //! \details Memory first touched afterwards is then local to the NUMA node of the processor
+    bool _pin(size_t worker) const;
+
+  private:
+    void _loop(size_t worker);
+    //! \brief Create the thread of index \a worker
+    void _add_thread(size_t worker);
+    //! \brief Evaluate \a points on \a input at \a fidelity, in waves of at most the concurrency, returning the scores
+    List<PointScore> _evaluate_in_waves(shared_ptr<InputType const> const& input, List<ConfigurationSearchPoint> const& points, double fidelity);
+    //! \brief Screen candidates around \a points by successive halving, returning as many points for full fidelity
+    List<ConfigurationSearchPoint> _screen(shared_ptr<InputType const> const& input, List<ConfigurationSearchPoint> const& points);
+    //! \brief The checkpoint data for the current state, taken between a pull and the next push
+    //! \details Built synchronously at the end of each pull, since the state changes with the next push, and only then
+    //! handed to the checkpoint writer thread; hence its cost follows the size of the state of the exploration. The scores
+    //! of the steps are not included, since the checkpoint writer appends them to its history
+    String _snapshot() const;
+    //! \brief Take a decision of the given \a kind with \a decide, or replay it from the decision log, recording it if needed
+    template<class F> Set<ConfigurationSearchPoint> _decision(DecisionKind kind, F const& decide);
+  private:
+    size_t _concurrency; // Number of threads to be used, changed with the input mutex locked
+    std::atomic<size_t> _requested_concurrency; // Zero if no change is requested
+    std::atomic<bool> _restart_requested; // From the initial point, once active
     std::atomic<unsigned int> _failures; // Number of task failures after a given push, reset during pulling
-    Buffer<InputType> _last_used_input;
+    Buffer<shared_ptr<InputType const>> _last_used_input;
     ConfigurationSearchPoint _initial_point;
+    SearchPointEncoder _point_encoder;
     std::queue<ConfigurationSearchPoint> _points;
     std::shared_ptr<ExplorationInterface> _exploration;
+    std::shared_ptr<InitialisationInterface> _initialisation;
+    SuccessiveHalvingSchedule const _schedule;
+    shared_ptr<CheckpointWriter> _checkpoint_writer;
+    RandomGenerator _generator;
+    shared_ptr<DecisionLog> _decision_log;
+    shared_ptr<TraceRecorder> _trace_recorder;
+    std::atomic<size_t> _steps; // Number of completed pulls, for tracing
+    AffinityPolicy const _affinity;
+    List<ProcessorLocation> const _topology;
+    size_t const _settings_version;
+    double const _runtime_weight;
+    SingletonCache<C> _singletons;
     // Synchronization
     List<shared_ptr<Thread>> _threads;
     InputBufferType _input_buffer;
@@ -144,6 +264,198 @@ private:
     std::condition_variable _output_availability;
 };
 
+//! \brief Run a task by parameter search as ParameterSearchRunner, but with each step bounded by a wall-clock budget
+//! \details Each thread owns a slot for one task, whose storage is allocated when the runner is made, while the points, their
+//! scores and the best output are still allocated at each step. A pull waits for the
+//! tasks until a margin before the end of the budget from the push, then scores the tasks completed, chooses the next points
+//! and returns the best output, or the best output of the last step completing any task if none completed in time. The margin
+//! follows the time taken by this processing in the previous steps, up to half the budget, hence a pull returns within the
+//! budget unless the processing takes longer than in the previous steps. Late tasks are left running, their results discarded, and their
+//! threads are given no point until they complete. Hence the input is copied once per step, by assignment into one of the
+//! inputs kept since the runner is made that no late task uses, and it must not refer to data released by the caller after the step. Tasks are scored by the caller when pulling, so that late tasks never race
+//! with the update of the constraining state. Checkpoints, decision logs and traces are not supported.
+template<class C> class RealTimeRunner final : public TaskRunnerBase<C> {
+    friend class TaskManager;
+    typedef typename TaskRunnerBase<C>::InputType InputType;
+    typedef typename TaskRunnerBase<C>::OutputType OutputType;
+    typedef typename TaskRunnerBase<C>::ConfigurationType ConfigurationType;
+    typedef std::chrono::steady_clock Clock;
+
+    enum class SlotState { IDLE, ASSIGNED, RUNNING, DONE };
+    //! \brief The storage for the task of a thread
+    struct Slot {
+        SlotState state = SlotState::IDLE;
+        size_t step = 0;
+        size_t input_index = 0; // In the inputs of the runner
+        std::optional<ConfigurationSearchPoint> point;
+        std::optional<OutputType> output; // Empty if the task failed
+        double latency = 0.0; // In seconds
+    };
+  protected:
+    RealTimeRunner(ConfigurationType const& configuration, ParameterSearchSettings const& settings,
+                   ConfigurationSearchPoint const& initial_point, size_t concurrency, std::chrono::microseconds budget);
+  public:
+    virtual ~RealTimeRunner();
+
+    void push(InputType const& input) override final;
+    OutputType pull() override final;
+
+    //! \brief The wall-clock budget of a step, from push to the return of pull
+    std::chrono::microseconds budget() const;
+    //! \brief The number of tasks that did not complete within the budget of their step
+    size_t late_tasks() const;
+
+  private:
+    void _loop(size_t worker);
+  private:
+    //! \brief The fraction of the budget reserved for processing the completed tasks, before the processing is timed
+    static constexpr unsigned int INITIAL_MARGIN_DIVISOR = 10;
+    //! \brief The largest fraction of the budget reserved for processing, so that the tasks are given at least the rest
+    static constexpr unsigned int MAXIMUM_MARGIN_DIVISOR = 2;
+    size_t const _concurrency;
+    Clock::duration const _budget;
+    Clock::duration _margin; // Reserved at the end of the budget for processing the completed tasks
+    ConfigurationSearchPoint _initial_point;
+    std::shared_ptr<ExplorationInterface> _exploration;
+    std::shared_ptr<InitialisationInterface> _initialisation;
+    RandomGenerator _generator;
+    List<size_t> const _cpus;
+    double const _runtime_weight;
+    SingletonCache<C> _singletons;
+    // Preallocated to the concurrency
+    List<Slot> _slots;
+    List<std::optional<InputType>> _inputs; // One for each step whose tasks may be running, hence one more than the concurrency
+    size_t _input_index; // Of the current step
+    List<ConfigurationSearchPoint> _next_points;
+    List<size_t> _completed; // The slots completed within the step
+    List<PointScore> _point_scores;
+    std::optional<OutputType> _last_best_output;
+    // Synchronization
+    List<shared_ptr<Thread>> _threads;
+    size_t _step; // The current step, changed with the mutex locked
+    Clock::time_point _deadline;
+    size_t _num_assigned;
+    size_t _num_done;
+    size_t _late_tasks;
+    bool _active;
+    bool _terminate;
+    mutable std::mutex _mutex;
+    std::condition_variable _assignment;
+    std::condition_variable _completion;
+};
+
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+
+//! \brief Thrown when a worker process terminates while running a task
+class WorkerProcessException : public std::runtime_error {
+  public:
+    WorkerProcessException(String const& what) : std::runtime_error(what) { }
+};
+
+//! \brief The status of a result pushed by a process running a task
+enum class ProcessResultStatus : std::uint32_t { SUCCESS, FAILURE };
+//! \brief The size of the header of a result pushed by a process, with the status and the latency of the task
+constexpr size_t PROCESS_RESULT_HEADER_SIZE = sizeof(ProcessResultStatus) + sizeof(double);
+
+//! \brief Push into \a results the output of \a produce, or the message of its exception as a failure, from within a child process
+//! \details \a produce is called with the latency to set, which is pushed along with the output
+template<class O, class F> void push_process_result(SharedRingBuffer& results, F const& produce);
+//! \brief Read the result at \a data of \a size bytes, as pulled from \a results, then release it
+//! \details Returns the output with its \a latency, or nothing with the failure message set in \a failure
+template<class O> std::optional<O> pull_process_result(SharedRingBuffer& results, unsigned char const* data, size_t size, String& failure, double& latency);
+
+//! \brief Run a task by parameter search as ParameterSearchRunner, but with each task executed in a worker process
+//! \details Each thread of the search drives its own worker process, forked when the search becomes active, hence
+//! crashes, leaks and heap fragmentation due to a task do not affect the rest of the application. Inputs and outputs
+//! are exchanged through shared memory slots of a given capacity, as given by ProcessTransport. A worker that
+//! terminates, or that is killed for exceeding the task timeout, is forked again, with its task counted as failed.
+//! A worker terminates on its own once the application does. Workers should not log, since they are forked
+//! from a multithreaded process.
+template<class C> requires ProcessTransportable<TaskInput<C>> and ProcessTransportable<TaskOutput<C>>
+class ProcessPoolRunner final : public ParameterSearchRunner<C> {
+    friend class TaskManager;
+    typedef typename ParameterSearchRunner<C>::InputType InputType;
+    typedef typename ParameterSearchRunner<C>::OutputType OutputType;
+    typedef typename ParameterSearchRunner<C>::ConfigurationType ConfigurationType;
+
+    //! \brief A worker process along with the rings to send it requests and receive results
+    struct Worker {
+        pid_t pid;
+        shared_ptr<SharedRingBuffer> requests;
+        shared_ptr<SharedRingBuffer> results;
+    };
+    enum class RequestKind : std::uint32_t { EVALUATE, TERMINATE };
+    //! \brief The fixed part of a request, followed by the point coordinates and the input
+    struct RequestHeader {
+        RequestKind kind;
+        std::uint32_t num_coordinates;
+        double fidelity;
+    };
+    //! \brief How often a waiting thread checks that its worker process is still alive, and vice versa
+    static constexpr long WORKER_POLL_MILLISECONDS = 50;
+    //! \brief How long a worker process is given to terminate on its own
+    static constexpr long WORKER_TERMINATION_MILLISECONDS = 1000;
+  protected:
+    ProcessPoolRunner(ConfigurationType const& configuration, ParameterSearchSettings const& settings,
+                      ConfigurationSearchPoint const& initial_point, size_t concurrency, size_t slot_capacity,
+                      std::chrono::milliseconds task_timeout);
+  public:
+    virtual ~ProcessPoolRunner();
+
+    //! \brief The number of worker processes forked again after terminating
+    size_t restarts() const;
+
+  private:
+    void _activate() override final;
+    OutputType _execute(size_t worker, InputType const& input, ConfigurationSearchPoint const& point, double fidelity, double& latency) override final;
+    size_t _max_batch_size() const override final;
+    void _resize(size_t concurrency) override final;
+    //! \brief Fork the worker process of index \a worker
+    void _fork(size_t worker);
+    //! \brief Ask \a worker to terminate, with no request in progress, then wait for it or kill it
+    void _shutdown(Worker const& worker);
+    //! \brief Fork again the worker process of index \a worker, after it terminated
+    void _restart(size_t worker);
+    //! \brief Serve the requests to the worker of index \a worker, from within its process, until \a parent terminates
+    int _serve(size_t worker, pid_t parent);
+  private:
+    size_t const _slot_capacity;
+    std::chrono::milliseconds const _task_timeout;
+    List<Worker> _workers;
+    std::atomic<size_t> _restarts;
+};
+
+//! \brief Run a task by parameter search as ParameterSearchRunner, but with each task executed in a process forked for it
+//! \details The forked process shares the memory of the application copy-on-write as of the start of the task, hence
+//! the input, held once per step for all its tasks, is not transferred, which suits inputs referring to a large state.
+//! Only the output is transferred back, through a shared memory slot of a given capacity, as given by ProcessTransport.
+//! A process that terminates without a result, or that is killed for exceeding the task timeout, counts as a task failure.
+template<class C> requires ProcessTransportable<TaskOutput<C>>
+class ForkSnapshotRunner final : public ParameterSearchRunner<C> {
+    friend class TaskManager;
+    typedef typename ParameterSearchRunner<C>::InputType InputType;
+    typedef typename ParameterSearchRunner<C>::OutputType OutputType;
+    typedef typename ParameterSearchRunner<C>::ConfigurationType ConfigurationType;
+  protected:
+    ForkSnapshotRunner(ConfigurationType const& configuration, ParameterSearchSettings const& settings,
+                       ConfigurationSearchPoint const& initial_point, size_t concurrency, size_t slot_capacity,
+                       std::chrono::milliseconds task_timeout);
+  public:
+    virtual ~ForkSnapshotRunner();
+
+  private:
+    void _activate() override final;
+    OutputType _execute(size_t worker, InputType const& input, ConfigurationSearchPoint const& point, double fidelity, double& latency) override final;
+    size_t _max_batch_size() const override final;
+    void _resize(size_t concurrency) override final;
+  private:
+    size_t const _slot_capacity;
+    std::chrono::milliseconds const _task_timeout;
+    List<shared_ptr<SharedRingBuffer>> _results; // One for each thread
+};
+
+#endif // PEXPLORE_HAS_PROCESS_ISOLATION
+
 } // namespace pExplore
 
 #endif // PEXPLORE_TASK_RUNNER_HPP
@@ -33,9 +33,16 @@
 #ifndef PEXPLORE_TASK_RUNNER_TPL_HPP
 #define PEXPLORE_TASK_RUNNER_TPL_HPP
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+#include <utility>
 #include "pronest/configurable.tpl.hpp"
 #include "helper/string.hpp"
 #include "task.tpl.hpp"
+#include "static_constraint.hpp"
 #include "task_runner.hpp"
 #include "task_interface.hpp"
 #include "task_manager.hpp"
@@ -72,17 +79,27 @@ template<class C> void TaskRunnable<C>::set_runner(shared_ptr<TaskRunnerInterfac
 }
 
 template<class C> void TaskRunnable<C>::set_constraints(List<Constraint<C>> const& constraints) {
-    TaskManager::instance().choose_runner_for(*this,constraints,this->configuration().search_space().initial_point());
+    TaskManager::instance().choose_runner_for(*this,constraints,TaskManager::instance().initial_point(this->configuration().search_space()));
+}
+
+template<class C> template<class C0, class... CS> void TaskRunnable<C>::set_constraints(StaticConstraintSet<C0,CS...> const& static_constraints) {
+    TaskManager::instance().choose_runner_for(*this,static_constraints.constraining_state(),TaskManager::instance().initial_point(this->configuration().search_space()));
 }
 
 template<class C> void TaskRunnable<C>::set_initial_point(ConfigurationSearchPoint const& initial_point) {
-    TaskManager::instance().choose_runner_for(*this,this->runner()->task().constraining_state().constraints(),initial_point);
+    TaskManager::instance().choose_runner_for(*this,initial_point);
 }
 
 template<class C> ConstrainingState<C> const& TaskRunnable<C>::constraining_state() const {
     return this->runner()->task().constraining_state();
 }
 
+template<class C> void TaskRunnable<C>::restore_checkpoint(String const& filename) {
+    auto runner = std::dynamic_pointer_cast<ParameterSearchRunner<C>>(_runner);
+    HELPER_PRECONDITION(runner != nullptr)
+    runner->restore(filename);
+}
+
 template<class C> shared_ptr<TaskRunnerInterface<C>>& TaskRunnable<C>::runner() {
     return _runner;
 }
@@ -170,55 +187,293 @@ template<class C> auto DetachedRunner<C>::pull() -> OutputType {
     return result;
 }
 
-template<class C> void ParameterSearchRunner<C>::_loop() {
+template<class C> SingletonCache<C>::SingletonCache(ConfigurationType const& configuration)
+        : _configuration(configuration), _point_encoder(configuration.search_space()) { }
+
+template<class C> auto SingletonCache<C>::at(ConfigurationSearchPoint const& point) -> shared_ptr<ConfigurationType const> {
+    if (not _point_encoder.is_exact()) return std::make_shared<ConfigurationType const>(make_singleton(_configuration,point));
+    auto key = _point_encoder.encode(point);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto found = _singletons.find(key);
+        if (found != _singletons.end()) return found->second;
+    }
+    // Built outside the lock, since concurrent threads rarely build the same point
+    auto result = std::make_shared<ConfigurationType const>(make_singleton(_configuration,point));
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_singletons.size() >= CAPACITY) _singletons.clear();
+    return _singletons.emplace(key,result).first->second;
+}
+
+template<class C> void ParameterSearchRunner<C>::_loop(size_t worker) {
+    if (not _pin(worker))
+        CONCLOG_PRINTLN_AT(1,"could not pin worker " << worker << " to processor " << _affinity.processor_for(_topology,worker).value());
     while(true) {
         std::unique_lock<std::mutex> locker(_input_mutex);
-        _input_availability.wait(locker, [this]() { return _input_buffer.size()>0 || _terminate; });
-        if (_terminate) break;
+        _input_availability.wait(locker, [this,worker]() { return _input_buffer.size()>0 || _terminate || worker >= _concurrency; });
+        // Threads beyond the concurrency retire when it is reduced
+        if (_terminate or worker >= _concurrency) break;
         auto pkg = _input_buffer.pull();
         locker.unlock();
-        auto cfg = make_singleton(this->configuration(),pkg.second);
+        auto const& input = *std::get<0>(pkg);
+        auto const& points = std::get<1>(pkg);
+        auto fidelity = std::get<2>(pkg);
         try {
-            auto output = this->task().run(pkg.first,cfg);
-            auto point_score = this->task().constraining_state().evaluate(pkg.second,pkg.first,output);
-            _output_buffer.push({output,point_score});
+            double latency = 0.0;
+            List<OutputType> outputs;
+            if (points.size() == 1) outputs.push_back(_execute(worker,input,points.at(0),fidelity,latency));
+            else outputs = _execute_batch(input,points,latency);
+            if (outputs.size() != points.size())
+                throw std::runtime_error("The batch returned " + std::to_string(outputs.size()) + " outputs for " + std::to_string(points.size()) + " configurations");
+            // The latency of a batch is shared evenly among its points
+            latency /= static_cast<double>(points.size());
+            for (size_t i=0; i<points.size(); ++i) {
+                auto score = this->task().constraining_state().evaluate(input,outputs[i],false);
+                if (_runtime_weight > 0.0) score = score.with_cost(_runtime_weight*latency);
+                PointScore point_score(points[i],score);
+                if (_trace_recorder != nullptr and fidelity >= 1.0)
+                    _trace_recorder->record({points[i].coordinates(),_steps,latency,point_score.score()});
+                _output_buffer.push({outputs[i],point_score});
+            }
         } catch (std::exception& e) {
-            ++_failures;
+            _failures += static_cast<unsigned int>(points.size());
             CONCLOG_PRINTLN("task failed: " << e.what());
         }
         _output_availability.notify_all();
     }
 }
 
-template<class C> ParameterSearchRunner<C>::ParameterSearchRunner(ConfigurationType const& configuration, ExplorationInterface const& exploration, ConfigurationSearchPoint const& initial_point, size_t concurrency)
-        : TaskRunnerBase<C>(configuration), _concurrency(concurrency),
-          _failures(0), _last_used_input({1}), _initial_point(initial_point), _points(), _exploration(exploration.clone()),
-          _input_buffer({concurrency}),_output_buffer({concurrency}),
+template<class C> ParameterSearchRunner<C>::ParameterSearchRunner(ConfigurationType const& configuration, ParameterSearchSettings const& settings,
+                                                                  ConfigurationSearchPoint const& initial_point, size_t concurrency)
+        : TaskRunnerBase<C>(configuration), _concurrency(concurrency), _requested_concurrency(0), _restart_requested(false),
+          _failures(0), _last_used_input({1}), _initial_point(initial_point), _point_encoder(configuration.search_space()), _points(),
+          _exploration(settings.exploration->clone()), _initialisation(settings.initialisation->clone()), _schedule(settings.schedule),
+          _checkpoint_writer(settings.checkpoint_file.empty() ? nullptr : new CheckpointWriter(settings.checkpoint_file)),
+          _generator(derive_seed(settings.seed,0)), _decision_log(settings.decision_log), _trace_recorder(settings.trace_recorder), _steps(0),
+          _affinity(settings.affinity), _topology(settings.topology), _settings_version(settings.version), _runtime_weight(settings.runtime_weight),
+          _singletons(this->configuration()), _input_buffer({concurrency}),_output_buffer({concurrency}),
           _active(false), _terminate(false) {
-    for (unsigned int i=0; i<concurrency; ++i)
-        _threads.append(shared_ptr<Thread>(new Thread([this]() { _loop(); }, this->task().name() + (concurrency>=10 and i<10 ? "0" : "") + to_string(i), false)));
+    _exploration->set_seed(derive_seed(settings.seed,1));
+    _initialisation->set_seed(derive_seed(settings.seed,2));
+    for (size_t i=0; i<concurrency; ++i) _add_thread(i);
+}
+
+template<class C> void ParameterSearchRunner<C>::_add_thread(size_t worker) {
+    _threads.append(shared_ptr<Thread>(new Thread([this,worker]() { _loop(worker); }, this->task().name() + (_concurrency>=10 and worker<10 ? "0" : "") + to_string(worker), false)));
 }
 
 template<class C> ParameterSearchRunner<C>::~ParameterSearchRunner() {
+    _stop();
+}
+
+template<class C> void ParameterSearchRunner<C>::_stop() {
     _terminate = true;
     _input_availability.notify_all();
+    _threads.clear();
+}
+
+template<class C> void ParameterSearchRunner<C>::_activate() {
+    for (auto& thread : _threads) thread->activate();
+}
+
+template<class C> void ParameterSearchRunner<C>::set_concurrency(size_t concurrency) {
+    HELPER_PRECONDITION(concurrency > 0)
+    _requested_concurrency = std::min(concurrency,this->configuration().search_space().total_points());
+}
+
+template<class C> void ParameterSearchRunner<C>::set_initial_point(ConfigurationSearchPoint const& initial_point) {
+    _initial_point = initial_point;
+    _restart_requested = _active.load();
+}
+
+template<class C> void ParameterSearchRunner<C>::_resize(size_t concurrency) {
+    auto previous = _concurrency;
+    if (_active) {
+        List<ConfigurationSearchPoint> current;
+        for (; not _points.empty(); _points.pop()) current.push_back(_points.front());
+        auto resized = _decision(DecisionKind::RESIZED,[&,this]() {
+            Set<ConfigurationSearchPoint> result;
+            for (auto const& p : current) {
+                if (result.size() >= concurrency) break;
+                result.insert(p);
+            }
+            if (result.size() < concurrency) result = make_extended_set_by_shifting(result,concurrency,_generator);
+            return result;
+        });
+        for (auto const& p : resized) _points.push(p);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_input_mutex);
+        _concurrency = concurrency;
+    }
+    _input_availability.notify_all();
+    // Retiring threads are joined when destroyed
+    if (concurrency < previous) _threads.resize(concurrency);
+    _input_buffer.set_capacity(concurrency);
+    _output_buffer.set_capacity(concurrency);
+    for (size_t i=previous; i<concurrency; ++i) {
+        _add_thread(i);
+        if (_active) _threads.at(i)->activate();
+    }
+    CONCLOG_PRINTLN_AT(1,"concurrency changed from " << previous << " to " << concurrency);
+}
+
+template<class C> auto ParameterSearchRunner<C>::_execute(size_t, InputType const& input, ConfigurationSearchPoint const& point, double fidelity, double& latency) -> OutputType {
+    auto configuration = _singletons.at(point);
+    return _run(input,*configuration,fidelity,latency);
+}
+
+template<class C> auto ParameterSearchRunner<C>::_run(InputType const& input, ConfigurationType const& cfg, double fidelity, double& latency) const -> OutputType {
+    auto start = std::chrono::steady_clock::now();
+    auto result = (fidelity < 1.0 ? this->task().run_at_fidelity(input,cfg,fidelity) : this->task().run(input,cfg));
+    latency = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    return result;
+}
+
+template<class C> auto ParameterSearchRunner<C>::_execute_batch(InputType const& input, List<ConfigurationSearchPoint> const& points, double& latency) -> List<OutputType> {
+    // The shared pointers keep the configurations alive even if the cache is restarted meanwhile
+    List<shared_ptr<ConfigurationType const>> singletons;
+    List<ConfigurationType const*> cfgs;
+    singletons.reserve(points.size());
+    cfgs.reserve(points.size());
+    for (auto const& point : points) {
+        singletons.push_back(_singletons.at(point));
+        cfgs.push_back(singletons.back().get());
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto result = this->task().run_batch(input,std::span<ConfigurationType const* const>(cfgs.data(),cfgs.size()));
+    latency = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    return result;
+}
+
+template<class C> size_t ParameterSearchRunner<C>::_max_batch_size() const {
+    return this->task().max_batch_size();
+}
+
+template<class C> size_t ParameterSearchRunner<C>::concurrency() const {
+    return _concurrency;
+}
+
+template<class C> bool ParameterSearchRunner<C>::_pin(size_t worker) const {
+    // Placed by the policy rather than in turn, so that threads added when resizing take the processors not yet used
+    auto cpu = _affinity.processor_for(_topology,worker);
+    if (not cpu.has_value()) return true;
+    return pin_current_thread(cpu.value());
 }
 
 template<class C> void ParameterSearchRunner<C>::push(InputType const& input) {
+    auto requested = _requested_concurrency.exchange(0);
+    if (requested > 0 and requested != _concurrency) _resize(requested);
+    if (_restart_requested.exchange(false)) {
+        _points = {};
+        for (auto const& p : _decision(DecisionKind::INITIAL,[this]() { return _initialisation->initial_points(_initial_point,_concurrency); })) _points.push(p);
+    }
     if (not _active) {
         _active = true;
-        auto shifted = _initial_point.make_random_shifted(_concurrency);
-        for (auto const& point : shifted) _points.push(point);
-        for (auto& thread : _threads) thread->activate();
+        auto initial_points = _decision(DecisionKind::INITIAL,[this]() { return _initialisation->initial_points(_initial_point,_concurrency); });
+        for (auto const& point : initial_points) _points.push(point);
+        _activate();
     }
+    List<ConfigurationSearchPoint> points;
     for (size_t i=0; i<_concurrency; ++i) {
-        _input_buffer.push({input,_points.front()});
+        points.push_back(_points.front());
         _points.pop();
     }
-    _last_used_input.push(input);
+    auto features = this->task().context_features(input);
+    if (not features.empty()) {
+        Set<ConfigurationSearchPoint> pending;
+        for (auto const& p : points) pending.insert(p);
+        points.clear();
+        for (auto const& p : _decision(DecisionKind::CONTEXTUALISED,[&,this]() { return _exploration->contextualise(features,pending); }))
+            points.push_back(p);
+    }
+    auto shared_input = std::make_shared<InputType const>(input);
+    if (not _schedule.is_single_fidelity()) {
+        auto screened = _decision(DecisionKind::SCREENED,[&,this]() {
+            Set<ConfigurationSearchPoint> result;
+            for (auto const& p : _screen(shared_input,points)) result.insert(p);
+            return result;
+        });
+        points.clear();
+        for (auto const& p : screened) points.push_back(p);
+    }
+    auto batch_size = std::max<size_t>(_max_batch_size(),1);
+    for (size_t i=0; i<points.size(); i+=batch_size) {
+        List<ConfigurationSearchPoint> batch;
+        for (size_t j=i; j<std::min(i+batch_size,points.size()); ++j) batch.push_back(points[j]);
+        _input_buffer.push({shared_input,batch,1.0});
+    }
+    _last_used_input.push(shared_input);
     _input_availability.notify_all();
 }
 
+template<class C> template<class F> Set<ConfigurationSearchPoint> ParameterSearchRunner<C>::_decision(DecisionKind kind, F const& decide) {
+    if (_decision_log != nullptr and _decision_log->is_replaying())
+        return _decision_log->replay(kind,this->configuration().search_space());
+    Set<ConfigurationSearchPoint> result = decide();
+    if (_decision_log != nullptr) _decision_log->record(kind,result);
+    return result;
+}
+
+template<class C> List<PointScore> ParameterSearchRunner<C>::_evaluate_in_waves(shared_ptr<InputType const> const& input, List<ConfigurationSearchPoint> const& points, double fidelity) {
+    List<PointScore> result;
+    result.reserve(points.size());
+    size_t evaluated = 0;
+    while (evaluated < points.size()) {
+        auto wave_size = std::min(_concurrency,points.size()-evaluated);
+        for (size_t i=evaluated; i<evaluated+wave_size; ++i) {
+            List<ConfigurationSearchPoint> single;
+            single.push_back(points[i]);
+            _input_buffer.push({input,single,fidelity});
+        }
+        _input_availability.notify_all();
+        std::unique_lock<std::mutex> locker(_output_mutex);
+        _output_availability.wait(locker, [this,wave_size]() { return _output_buffer.size()>=wave_size-_failures; });
+        _failures=0;
+        while (_output_buffer.size() > 0)
+            result.push_back(_output_buffer.pull().point_score());
+        evaluated += wave_size;
+    }
+    // Sorted as when pulling, since the promotions depend on the order of equal scores
+    List<std::pair<SearchPointKey,size_t>> order;
+    order.reserve(result.size());
+    for (size_t i=0; i<result.size(); ++i) order.push_back({_point_encoder.encode(result[i].point()),i});
+    std::sort(order.begin(),order.end());
+    List<PointScore> sorted;
+    sorted.reserve(result.size());
+    for (auto const& entry : order) sorted.push_back(std::move(result[entry.second]));
+    return sorted;
+}
+
+template<class C> List<ConfigurationSearchPoint> ParameterSearchRunner<C>::_screen(shared_ptr<InputType const> const& input, List<ConfigurationSearchPoint> const& points) {
+    auto final_size = points.size();
+    Set<ConfigurationSearchPoint> sources;
+    for (auto const& p : points) sources.insert(p);
+    auto num_candidates = std::min(this->configuration().search_space().total_points(),_schedule.rung_size(0,final_size));
+    List<ConfigurationSearchPoint> candidates;
+    for (auto const& p : make_extended_set_by_shifting(sources,num_candidates,_generator)) candidates.push_back(p);
+
+    for (size_t rung=0; rung+1<_schedule.num_rungs(); ++rung) {
+        auto scores = _evaluate_in_waves(input,candidates,_schedule.fidelity(rung));
+        CONCLOG_PRINTLN_AT(1,"screened " << scores.size() << " points at fidelity " << _schedule.fidelity(rung));
+        auto num_promoted = std::min(scores.size(),std::max(final_size,_schedule.rung_size(rung+1,final_size)));
+        candidates.clear();
+        for (auto idx : best_score_indices(scores,num_promoted)) candidates.push_back(scores[idx].point());
+    }
+
+    Set<ConfigurationSearchPoint> result;
+    for (auto const& p : candidates) {
+        if (result.size() >= final_size) break;
+        result.insert(p);
+    }
+    // Failed screenings may leave fewer survivors than needed
+    if (result.empty()) return points;
+    if (result.size() < final_size) result = make_extended_set_by_shifting(result,final_size,_generator);
+    List<ConfigurationSearchPoint> survivors;
+    for (auto const& p : result) survivors.push_back(p);
+    return survivors;
+}
+
 template<class C> auto ParameterSearchRunner<C>::pull() -> OutputType {
     std::unique_lock<std::mutex> locker(_output_mutex);
     _output_availability.wait(locker, [this]() { return _output_buffer.size()>=_concurrency-_failures; });
@@ -226,38 +481,560 @@ template<class C> auto ParameterSearchRunner<C>::pull() -> OutputType {
     _failures=0;
 
     auto input = _last_used_input.pull();
-    Map<ConfigurationSearchPoint,OutputType> point_outputs;
-    Set<PointScore> point_scores;
-    Set<ConfigurationSearchPoint> points;
-    HELPER_ASSERT_EQUAL(_output_buffer.size(),_concurrency)
+    if (_output_buffer.size() == 0) {
+        // Restart from new initial points, so that the search can continue after the exception
+        for (auto const& p : _decision(DecisionKind::INITIAL,[this]() { return _initialisation->initial_points(_initial_point,_concurrency); })) _points.push(p);
+        throw std::runtime_error("All the " + std::to_string(_concurrency) + " tasks of the step failed");
+    }
+    List<PointScore> completed_scores;
+    List<OutputType> outputs;
+    // Each point is encoded once, the keys being compared when sorting
+    List<std::pair<SearchPointKey,size_t>> order;
+    SearchPointKeySet points(_concurrency);
+    completed_scores.reserve(_concurrency);
+    outputs.reserve(_concurrency);
+    order.reserve(_concurrency);
     while (_output_buffer.size() > 0) {
         auto data = _output_buffer.pull();
-        point_scores.insert(data.point_score());
-        points.insert(data.point_score().point());
-        point_outputs.insert(Pair<ConfigurationSearchPoint,OutputType>(data.point_score().point(),data.output()));
+        order.push_back({_point_encoder.encode(data.point_score().point()),completed_scores.size()});
+        points.insert(order.back().first);
+        completed_scores.push_back(data.point_score());
+        outputs.push_back(data.output());
+    }
+    // Distinct points have distinct keys only when encoded exactly, since hashed keys may collide
+    if (_point_encoder.is_exact()) {
+        HELPER_ASSERT_EQUAL(points.size(),completed_scores.size())
     }
-    HELPER_ASSERT_EQUAL(points.size(),_concurrency)
-    HELPER_ASSERT_EQUAL(point_scores.size(),_concurrency)
+    // Tasks complete in any order, hence the scores are sorted for the decisions to depend on the seed only
+    std::sort(order.begin(),order.end());
+    List<PointScore> point_scores;
+    point_scores.reserve(order.size());
+    for (auto const& entry : order) point_scores.push_back(std::move(completed_scores[entry.second]));
 
-    auto new_points = _exploration->next_points_from(point_scores);
+    auto new_points = _decision(DecisionKind::NEXT,[&,this]() {
+        auto result = _exploration->next_points_from(point_scores);
+        // Failed tasks leave fewer points than the concurrency
+        if (result.size() < _concurrency) result = make_extended_set_by_shifting(result,_concurrency,_generator);
+        return result;
+    });
     for (auto const& p : new_points) _points.push(p);
     CONCLOG_PRINTLN_VAR(new_points);
 
     HELPER_ASSERT_EQUAL(_points.size(),_concurrency)
 
-    auto best_point_score = *point_scores.begin();
-    auto best_output = point_outputs.get(best_point_score.point());
+    auto best_output = outputs.at(order[best_score_index(point_scores)].second);
 
-    this->task().update_constraining_state(input,best_output);
+    this->task().update_constraining_state(*input,best_output);
 
     if (this->task().constraining_state().has_no_active_constraints())
         throw new NoActiveConstraintsException(this->task().constraining_state().states());
 
     TaskManager::instance().append_scores(point_scores);
+    ++_steps;
+
+    if (_checkpoint_writer != nullptr) _checkpoint_writer->write(_snapshot(),point_scores);
 
     return best_output;
 }
 
+template<class C> String ParameterSearchRunner<C>::_snapshot() const {
+    auto const& space = this->configuration().search_space();
+    BinaryWriter writer;
+    writer.write(CHECKPOINT_MAGIC);
+    writer.write(CHECKPOINT_VERSION);
+    writer.write(this->task().name());
+    writer.write<std::uint64_t>(space.dimension());
+    writer.write<std::uint64_t>(_concurrency);
+    writer.write<std::uint64_t>(_steps);
+    writer.write(static_cast<bool>(_active));
+    write_generator(writer,_generator);
+    write_point(writer,_initial_point);
+    auto points = _points;
+    writer.write<std::uint64_t>(points.size());
+    for (; not points.empty(); points.pop()) write_point(writer,points.front());
+    this->task().constraining_state().save_state(writer);
+    _exploration->save_state(writer);
+    // Initial points are drawn again when all the tasks of a step fail
+    _initialisation->save_state(writer);
+    return writer.data();
+}
+
+template<class C> void ParameterSearchRunner<C>::restore(String const& filename) {
+    auto const& space = this->configuration().search_space();
+    // Everything is read into copies, so that the search is left untouched if the checkpoint is invalid
+    size_t steps = 0;
+    bool active = false;
+    RandomGenerator generator;
+    auto initial_point = _initial_point;
+    std::queue<ConfigurationSearchPoint> points;
+    auto constraining_state = this->task().constraining_state().clone();
+    shared_ptr<ExplorationInterface> exploration(_exploration->clone());
+    shared_ptr<InitialisationInterface> initialisation(_initialisation->clone());
+    List<List<PointScore>> scores;
+    try {
+        BinaryReader reader(read_binary_file(filename));
+        if (reader.read<std::uint32_t>() != CHECKPOINT_MAGIC) throw DeserialisationException("File '" + filename + "' is not a checkpoint");
+        auto version = reader.read<std::uint32_t>();
+        if (version != CHECKPOINT_VERSION) throw DeserialisationException("Unsupported checkpoint version " + std::to_string(version));
+        auto name = reader.read_string();
+        if (name != this->task().name()) throw DeserialisationException("Checkpoint is for task '" + name + "', not '" + this->task().name() + "'");
+        if (reader.read<std::uint64_t>() != space.dimension()) throw DeserialisationException("Checkpoint search space dimension does not match");
+        if (reader.read<std::uint64_t>() != _concurrency) throw DeserialisationException("Checkpoint concurrency does not match");
+        steps = static_cast<size_t>(reader.read<std::uint64_t>());
+        active = reader.read<bool>();
+        read_generator(reader,generator);
+        initial_point = read_point(reader,space);
+        auto num_points = static_cast<size_t>(reader.read<std::uint64_t>());
+        for (size_t i=0; i<num_points; ++i) points.push(read_point(reader,space));
+        constraining_state.load_state(reader);
+        exploration->load_state(reader,space);
+        initialisation->load_state(reader);
+        auto num_steps = static_cast<size_t>(reader.read<std::uint64_t>());
+        auto history_size = static_cast<size_t>(reader.read<std::uint64_t>());
+        if (not reader.at_end()) throw DeserialisationException("Unexpected trailing data in checkpoint '" + filename + "'");
+        auto history_data = read_binary_file(CheckpointWriter::history_filename(filename));
+        if (history_data.size() < history_size) throw DeserialisationException("History of checkpoint '" + filename + "' is truncated");
+        history_data.resize(history_size);
+        BinaryReader history_reader(history_data);
+        scores.reserve(num_steps);
+        for (size_t i=0; i<num_steps; ++i) {
+            List<PointScore> step_scores;
+            auto num_scores = static_cast<size_t>(history_reader.read<std::uint64_t>());
+            for (size_t j=0; j<num_scores; ++j) step_scores.push_back(read_point_score(history_reader,space));
+            scores.push_back(step_scores);
+        }
+        if (not history_reader.at_end()) throw DeserialisationException("Unexpected trailing data in the history of checkpoint '" + filename + "'");
+    } catch (DeserialisationException const&) {
+        throw;
+    } catch (std::exception const& e) {
+        throw DeserialisationException("Invalid checkpoint '" + filename + "': " + e.what());
+    }
+
+    _initial_point = initial_point;
+    std::swap(_points,points);
+    _generator = generator;
+    _steps = steps;
+    this->task().set_constraining_state(constraining_state);
+    _exploration = exploration;
+    _initialisation = initialisation;
+    for (auto const& step_scores : scores) TaskManager::instance().append_scores(step_scores);
+    if (_checkpoint_writer != nullptr) _checkpoint_writer->reset_history(scores);
+    if (active and not _active) {
+        _active = true;
+        _activate();
+    }
+    CONCLOG_PRINTLN_AT(1,"restored checkpoint '" << filename << "' after " << scores.size() << " steps");
+}
+
+template<class C> RealTimeRunner<C>::RealTimeRunner(ConfigurationType const& configuration, ParameterSearchSettings const& settings,
+                                                    ConfigurationSearchPoint const& initial_point, size_t concurrency, std::chrono::microseconds budget)
+        : TaskRunnerBase<C>(configuration), _concurrency(concurrency), _budget(std::chrono::duration_cast<Clock::duration>(budget)),
+          _margin(_budget/INITIAL_MARGIN_DIVISOR), _initial_point(initial_point), _exploration(settings.exploration->clone()),
+          _initialisation(settings.initialisation->clone()), _generator(derive_seed(settings.seed,0)), _cpus(settings.affinity.assign(settings.topology,concurrency)),
+          _runtime_weight(settings.runtime_weight), _singletons(this->configuration()), _input_index(0), _step(0), _num_assigned(0), _num_done(0), _late_tasks(0), _active(false), _terminate(false) {
+    HELPER_PRECONDITION(budget.count() > 0)
+    _exploration->set_seed(derive_seed(settings.seed,1));
+    _initialisation->set_seed(derive_seed(settings.seed,2));
+    _slots.resize(concurrency);
+    _inputs.resize(concurrency+1);
+    _next_points.reserve(concurrency);
+    _completed.reserve(concurrency);
+    _point_scores.reserve(concurrency);
+    for (size_t i=0; i<concurrency; ++i)
+        _threads.append(shared_ptr<Thread>(new Thread([this,i]() { _loop(i); }, this->task().name() + (concurrency>=10 and i<10 ? "0" : "") + to_string(i), false)));
+}
+
+template<class C> RealTimeRunner<C>::~RealTimeRunner() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _terminate = true;
+    }
+    _assignment.notify_all();
+    // Waits for late tasks still running
+    _threads.clear();
+}
+
+template<class C> std::chrono::microseconds RealTimeRunner<C>::budget() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(_budget);
+}
+
+template<class C> size_t RealTimeRunner<C>::late_tasks() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _late_tasks;
+}
+
+template<class C> void RealTimeRunner<C>::_loop(size_t worker) {
+    if (not _cpus.empty() and not pin_current_thread(_cpus.at(worker % _cpus.size())))
+        CONCLOG_PRINTLN_AT(1,"could not pin worker " << worker << " to processor " << _cpus.at(worker % _cpus.size()));
+    auto& slot = _slots[worker];
+    while(true) {
+        std::unique_lock<std::mutex> locker(_mutex);
+        _assignment.wait(locker, [this,&slot]() { return _terminate or slot.state == SlotState::ASSIGNED; });
+        if (_terminate) break;
+        // Once running, the slot is not changed by pushing
+        slot.state = SlotState::RUNNING;
+        auto step = slot.step;
+        locker.unlock();
+        std::optional<OutputType> output;
+        double latency = 0.0;
+        try {
+            auto configuration = _singletons.at(*slot.point);
+            auto start = Clock::now();
+            output.emplace(this->task().run(*_inputs[slot.input_index],*configuration));
+            latency = std::chrono::duration<double>(Clock::now()-start).count();
+        } catch (std::exception& e) {
+            CONCLOG_PRINTLN("task failed: " << e.what());
+        }
+        locker.lock();
+        if (output.has_value()) slot.output.emplace(std::move(output.value()));
+        slot.latency = latency;
+        slot.state = SlotState::DONE;
+        if (step == _step) ++_num_done;
+        locker.unlock();
+        _completion.notify_all();
+    }
+}
+
+template<class C> void RealTimeRunner<C>::push(InputType const& input) {
+    if (not _active) {
+        _active = true;
+        for (auto const& p : _initialisation->initial_points(_initial_point,_concurrency)) _next_points.push_back(p);
+        for (auto& thread : _threads) thread->activate();
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_step;
+    _deadline = Clock::now() + _budget;
+    _num_assigned = 0;
+    _num_done = 0;
+    // The input of the previous step is reused unless a late task still uses it, so that its storage is assigned in place
+    auto is_used = [this](size_t index) {
+        return std::any_of(_slots.begin(),_slots.end(),[index](Slot const& s) { return s.state == SlotState::RUNNING and s.input_index == index; }); };
+    while (is_used(_input_index)) _input_index = (_input_index+1) % _inputs.size();
+    if constexpr (std::is_copy_assignable_v<InputType>) _inputs[_input_index] = input;
+    else _inputs[_input_index].emplace(input);
+    for (auto& slot : _slots) {
+        if (_num_assigned == _next_points.size()) break;
+        // The thread is still running a late task
+        if (slot.state == SlotState::RUNNING) continue;
+        slot.input_index = _input_index;
+        slot.point = _next_points[_num_assigned++];
+        slot.output.reset();
+        slot.step = _step;
+        slot.state = SlotState::ASSIGNED;
+    }
+    _assignment.notify_all();
+}
+
+template<class C> auto RealTimeRunner<C>::pull() -> OutputType {
+    std::unique_lock<std::mutex> locker(_mutex);
+    _completion.wait_until(locker, _deadline-_margin, [this]() { return _num_done == _num_assigned; });
+    auto processing_start = Clock::now();
+    _completed.clear();
+    for (size_t i=0; i<_slots.size(); ++i) {
+        auto& slot = _slots[i];
+        if (slot.step != _step) continue;
+        if (slot.state == SlotState::DONE) {
+            if (slot.output.has_value()) _completed.push_back(i);
+        } else if (slot.state != SlotState::IDLE) {
+            // Tasks not yet started are dropped, the running ones are left to complete
+            if (slot.state == SlotState::ASSIGNED) slot.state = SlotState::IDLE;
+            ++_late_tasks;
+        }
+    }
+    locker.unlock();
+    CONCLOG_PRINTLN("received " << _completed.size() << " tasks completed within the budget");
+
+    // Completed slots are changed only by pushing
+    _point_scores.clear();
+    for (auto i : _completed) {
+        auto const& slot = _slots[i];
+        auto score = this->task().constraining_state().evaluate(*_inputs[slot.input_index],*slot.output,false);
+        if (_runtime_weight > 0.0) score = score.with_cost(_runtime_weight*slot.latency);
+        _point_scores.push_back({*slot.point,score});
+    }
+    if (_point_scores.empty()) {
+        if (not _last_best_output.has_value()) throw std::runtime_error("No task completed within the budget of the step");
+        CONCLOG_PRINTLN_AT(1,"no task completed within the budget, returning the last best output");
+        return _last_best_output.value();
+    }
+    auto const& best = _slots[_completed[best_score_index(_point_scores)]];
+
+    this->task().update_constraining_state(*_inputs[best.input_index],*best.output);
+
+    if (this->task().constraining_state().has_no_active_constraints())
+        throw new NoActiveConstraintsException(this->task().constraining_state().states());
+
+    auto next_points = _exploration->next_points_from(_point_scores);
+    // Late or failed tasks leave fewer points than the concurrency
+    if (next_points.size() < _concurrency) next_points = make_extended_set_by_shifting(next_points,_concurrency,_generator);
+    _next_points.clear();
+    for (auto const& p : next_points) {
+        if (_next_points.size() == _concurrency) break;
+        _next_points.push_back(p);
+    }
+
+    TaskManager::instance().append_scores(_point_scores);
+    _last_best_output.emplace(*best.output);
+
+    // Twice the processing time, for the variability between steps, while slowly releasing the margin of slower steps
+    _margin = std::min(std::max(2*(Clock::now()-processing_start),_margin-_margin/8),_budget/MAXIMUM_MARGIN_DIVISOR);
+    return *best.output;
+}
+
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+
+template<class O, class F> void push_process_result(SharedRingBuffer& results, F const& produce) {
+    auto data = results.begin_push();
+    auto capacity = results.slot_capacity();
+    auto status = ProcessResultStatus::SUCCESS;
+    double latency = 0.0;
+    size_t payload_size = 0;
+    try {
+        O output = produce(latency);
+        payload_size = ProcessTransport<O>::size(output);
+        if (PROCESS_RESULT_HEADER_SIZE+payload_size > capacity)
+            throw std::runtime_error("The output of " + std::to_string(payload_size) + " bytes exceeds the slot capacity of " + std::to_string(capacity) + " bytes");
+        ProcessTransport<O>::write(output,data+PROCESS_RESULT_HEADER_SIZE);
+    } catch (std::exception& e) {
+        status = ProcessResultStatus::FAILURE;
+        String message = e.what();
+        payload_size = std::min(message.size(),capacity-PROCESS_RESULT_HEADER_SIZE);
+        std::memcpy(data+PROCESS_RESULT_HEADER_SIZE,message.data(),payload_size);
+    }
+    std::memcpy(data,&status,sizeof(status));
+    std::memcpy(data+sizeof(status),&latency,sizeof(latency));
+    results.end_push(PROCESS_RESULT_HEADER_SIZE+payload_size);
+}
+
+template<class O> std::optional<O> pull_process_result(SharedRingBuffer& results, unsigned char const* data, size_t size, String& failure, double& latency) {
+    ProcessResultStatus status;
+    std::memcpy(&status,data,sizeof(status));
+    std::memcpy(&latency,data+sizeof(status),sizeof(latency));
+    auto payload = data+PROCESS_RESULT_HEADER_SIZE;
+    auto payload_size = size-PROCESS_RESULT_HEADER_SIZE;
+    std::optional<O> result;
+    if (status == ProcessResultStatus::SUCCESS) result.emplace(ProcessTransport<O>::read(payload,payload_size));
+    else failure = String(reinterpret_cast<char const*>(payload),payload_size);
+    results.end_pull();
+    return result;
+}
+
+template<class C> requires ProcessTransportable<TaskInput<C>> and ProcessTransportable<TaskOutput<C>>
+ProcessPoolRunner<C>::ProcessPoolRunner(ConfigurationType const& configuration, ParameterSearchSettings const& settings,
+                                        ConfigurationSearchPoint const& initial_point, size_t concurrency, size_t slot_capacity,
+                                        std::chrono::milliseconds task_timeout)
+        : ParameterSearchRunner<C>(configuration,settings,initial_point,concurrency), _slot_capacity(slot_capacity),
+          _task_timeout(task_timeout), _restarts(0) {
+    HELPER_PRECONDITION(slot_capacity > sizeof(RequestHeader))
+    HELPER_PRECONDITION(task_timeout.count() > 0)
+}
+
+template<class C> requires ProcessTransportable<TaskInput<C>> and ProcessTransportable<TaskOutput<C>>
+ProcessPoolRunner<C>::~ProcessPoolRunner() {
+    this->_stop();
+    // With the threads terminated, no request is in progress
+    for (auto const& worker : _workers) _shutdown(worker);
+}
+
+template<class C> requires ProcessTransportable<TaskInput<C>> and ProcessTransportable<TaskOutput<C>>
+void ProcessPoolRunner<C>::_shutdown(Worker const& worker) {
+    RequestHeader header = {RequestKind::TERMINATE,0,0.0};
+    std::memcpy(worker.requests->begin_push(),&header,sizeof(header));
+    worker.requests->end_push(sizeof(header));
+    terminate_process(worker.pid,WORKER_TERMINATION_MILLISECONDS);
+}
+
+template<class C> requires ProcessTransportable<TaskInput<C>> and ProcessTransportable<TaskOutput<C>>
+size_t ProcessPoolRunner<C>::restarts() const {
+    return _restarts;
+}
+
+template<class C> requires ProcessTransportable<TaskInput<C>> and ProcessTransportable<TaskOutput<C>>
+size_t ProcessPoolRunner<C>::_max_batch_size() const {
+    return 1;
+}
+
+template<class C> requires ProcessTransportable<TaskInput<C>> and ProcessTransportable<TaskOutput<C>>
+void ProcessPoolRunner<C>::_activate() {
+    // Workers are forked before the threads start, hence they have a consistent copy of the runner
+    for (size_t i=0; i<this->concurrency(); ++i) {
+        _workers.push_back({0,std::make_shared<SharedRingBuffer>(1,_slot_capacity),std::make_shared<SharedRingBuffer>(1,_slot_capacity)});
+        _fork(i);
+    }
+    ParameterSearchRunner<C>::_activate();
+}
+
+template<class C> requires ProcessTransportable<TaskInput<C>> and ProcessTransportable<TaskOutput<C>>
+void ProcessPoolRunner<C>::_resize(size_t concurrency) {
+    // Workers exist only once active, and are needed by the threads as soon as these start
+    for (size_t i=_workers.size(); not _workers.empty() and i<concurrency; ++i) {
+        _workers.push_back({0,std::make_shared<SharedRingBuffer>(1,_slot_capacity),std::make_shared<SharedRingBuffer>(1,_slot_capacity)});
+        _fork(i);
+    }
+    ParameterSearchRunner<C>::_resize(concurrency);
+    for (; _workers.size() > concurrency; _workers.pop_back()) _shutdown(_workers.back());
+}
+
+template<class C> requires ProcessTransportable<TaskInput<C>> and ProcessTransportable<TaskOutput<C>>
+void ProcessPoolRunner<C>::_fork(size_t worker) {
+    auto parent = getpid();
+    _workers.at(worker).pid = fork_process([this,worker,parent]() { return _serve(worker,parent); });
+}
+
+template<class C> requires ProcessTransportable<TaskInput<C>> and ProcessTransportable<TaskOutput<C>>
+void ProcessPoolRunner<C>::_restart(size_t worker) {
+    auto& w = _workers.at(worker);
+    w.requests->reset();
+    w.results->reset();
+    ++_restarts;
+    CONCLOG_PRINTLN("worker process " << worker << " terminated, forking it again");
+    _fork(worker);
+}
+
+template<class C> requires ProcessTransportable<TaskInput<C>> and ProcessTransportable<TaskOutput<C>>
+auto ProcessPoolRunner<C>::_execute(size_t worker, InputType const& input, ConfigurationSearchPoint const& point, double fidelity, double& latency) -> OutputType {
+    auto& w = _workers.at(worker);
+    List<int> coordinates = point.coordinates();
+    auto coordinates_size = coordinates.size()*sizeof(int);
+    auto request_size = sizeof(RequestHeader) + coordinates_size + ProcessTransport<InputType>::size(input);
+    if (request_size > _slot_capacity)
+        throw std::runtime_error("The request of " + std::to_string(request_size) + " bytes exceeds the slot capacity of " + std::to_string(_slot_capacity) + " bytes");
+    RequestHeader header = {RequestKind::EVALUATE,static_cast<std::uint32_t>(coordinates.size()),fidelity};
+    auto request = w.requests->begin_push();
+    std::memcpy(request,&header,sizeof(header));
+    std::memcpy(request+sizeof(header),coordinates.data(),coordinates_size);
+    ProcessTransport<InputType>::write(input,request+sizeof(header)+coordinates_size);
+    w.requests->end_push(request_size);
+
+    auto deadline = std::chrono::steady_clock::now() + _task_timeout;
+    size_t result_size = 0;
+    unsigned char const* result = nullptr;
+    bool terminated = false;
+    bool timed_out = false;
+    while (result == nullptr and not terminated and not timed_out) {
+        result = w.results->begin_pull(result_size,WORKER_POLL_MILLISECONDS);
+        if (result == nullptr) {
+            terminated = has_terminated(w.pid);
+            // The worker may have completed just before terminating
+            if (terminated) result = w.results->begin_pull(result_size,0);
+            else timed_out = std::chrono::steady_clock::now() >= deadline;
+        }
+    }
+    if (timed_out) {
+        terminate_process(w.pid,0);
+        _restart(worker);
+        throw WorkerProcessException("Worker process " + std::to_string(worker) + " was killed after " + std::to_string(_task_timeout.count()) + " ms running the task at " + to_string(point));
+    }
+    if (result == nullptr) {
+        _restart(worker);
+        throw WorkerProcessException("Worker process " + std::to_string(worker) + " terminated while running the task at " + to_string(point));
+    }
+    String failure;
+    auto output = pull_process_result<OutputType>(*w.results,result,result_size,failure,latency);
+    if (terminated) _restart(worker);
+    if (not output.has_value()) throw std::runtime_error(failure);
+    return std::move(output.value());
+}
+
+template<class C> requires ProcessTransportable<TaskInput<C>> and ProcessTransportable<TaskOutput<C>>
+int ProcessPoolRunner<C>::_serve(size_t worker, pid_t parent) {
+    // Forked from another thread, hence pinned on its own; a failure is ignored since the process must not log
+    this->_pin(worker);
+    auto& w = _workers.at(worker);
+    auto const& space = this->configuration().search_space();
+    while (true) {
+        size_t request_size = 0;
+        auto request = w.requests->begin_pull(request_size,WORKER_POLL_MILLISECONDS);
+        // Once the application terminates, no request will follow and the worker is reparented
+        if (request == nullptr) {
+            if (getppid() != parent) return 0;
+            continue;
+        }
+        RequestHeader header;
+        std::memcpy(&header,request,sizeof(header));
+        if (header.kind == RequestKind::TERMINATE) {
+            w.requests->end_pull();
+            return 0;
+        }
+        List<int> coordinates;
+        coordinates.resize(header.num_coordinates);
+        auto coordinates_size = coordinates.size()*sizeof(int);
+        std::memcpy(coordinates.data(),request+sizeof(header),coordinates_size);
+        auto input_offset = sizeof(header)+coordinates_size;
+        auto input = ProcessTransport<InputType>::read(request+input_offset,request_size-input_offset);
+        w.requests->end_pull();
+
+        push_process_result<OutputType>(*w.results,[&,this](double& latency) {
+            auto configuration = make_singleton(this->configuration(),make_point_from_coordinates(space,coordinates));
+            return this->_run(input,configuration,header.fidelity,latency);
+        });
+    }
+}
+
+template<class C> requires ProcessTransportable<TaskOutput<C>>
+ForkSnapshotRunner<C>::ForkSnapshotRunner(ConfigurationType const& configuration, ParameterSearchSettings const& settings,
+                                          ConfigurationSearchPoint const& initial_point, size_t concurrency, size_t slot_capacity,
+                                          std::chrono::milliseconds task_timeout)
+        : ParameterSearchRunner<C>(configuration,settings,initial_point,concurrency), _slot_capacity(slot_capacity), _task_timeout(task_timeout) {
+    HELPER_PRECONDITION(slot_capacity > PROCESS_RESULT_HEADER_SIZE)
+    HELPER_PRECONDITION(task_timeout.count() > 0)
+}
+
+template<class C> requires ProcessTransportable<TaskOutput<C>>
+ForkSnapshotRunner<C>::~ForkSnapshotRunner() {
+    // The threads wait for their forked processes, which use the shared memory
+    this->_stop();
+}
+
+template<class C> requires ProcessTransportable<TaskOutput<C>>
+size_t ForkSnapshotRunner<C>::_max_batch_size() const {
+    return 1;
+}
+
+template<class C> requires ProcessTransportable<TaskOutput<C>>
+void ForkSnapshotRunner<C>::_activate() {
+    for (size_t i=0; i<this->concurrency(); ++i)
+        _results.push_back(std::make_shared<SharedRingBuffer>(1,_slot_capacity));
+    ParameterSearchRunner<C>::_activate();
+}
+
+template<class C> requires ProcessTransportable<TaskOutput<C>>
+void ForkSnapshotRunner<C>::_resize(size_t concurrency) {
+    for (size_t i=_results.size(); not _results.empty() and i<concurrency; ++i)
+        _results.push_back(std::make_shared<SharedRingBuffer>(1,_slot_capacity));
+    ParameterSearchRunner<C>::_resize(concurrency);
+    if (_results.size() > concurrency) _results.resize(concurrency);
+}
+
+template<class C> requires ProcessTransportable<TaskOutput<C>>
+auto ForkSnapshotRunner<C>::_execute(size_t worker, InputType const& input, ConfigurationSearchPoint const& point, double fidelity, double& latency) -> OutputType {
+    auto& results = *_results.at(worker);
+    auto pid = fork_process([&,this]() {
+        push_process_result<OutputType>(results,[&,this](double& task_latency) {
+            auto configuration = make_singleton(this->configuration(),point);
+            return this->_run(input,configuration,fidelity,task_latency);
+        });
+        return 0;
+    });
+    if (not wait_process(pid,static_cast<long>(_task_timeout.count()))) {
+        // The process may have been killed while pushing its result
+        results.reset();
+        throw WorkerProcessException("The process forked for the task at " + to_string(point) + " was killed after " + std::to_string(_task_timeout.count()) + " ms");
+    }
+    size_t size = 0;
+    auto data = results.begin_pull(size,0);
+    if (data == nullptr) {
+        results.reset();
+        throw WorkerProcessException("The process forked for the task at " + to_string(point) + " terminated without a result");
+    }
+    String failure;
+    auto output = pull_process_result<OutputType>(results,data,size,failure,latency);
+    if (not output.has_value()) throw std::runtime_error(failure);
+    return std::move(output.value());
+}
+
+#endif // PEXPLORE_HAS_PROCESS_ISOLATION
+
 } // namespace pExplore
 
 #endif // PEXPLORE_TASK_RUNNER_TPL_HPP
@@ -72,10 +72,17 @@ class TaskRunnable : public Configurable<C> {
   public:
     //! \brief Set the constraints for this runnable, to rank results from multiple configurations
     void set_constraints(List<Constraint<C>> const& constraining);
+    //! \brief Set the constraints for this runnable from a \a static_constraints set, which evaluates them without indirect calls
+    //! \details The first constraint type is named apart, so that a braced list of constraints never deduces an empty set
+    template<class C0, class... CS> void set_constraints(StaticConstraintSet<C0,CS...> const& static_constraints);
     //! \brief Set the initial point, instead of generating a random one automatically
     void set_initial_point(ConfigurationSearchPoint const& initial_point);
     //! \brief The constraining state held by the task
     ConstrainingState<C> const& constraining_state() const;
+    //! \brief Restore the search from the checkpoint in \a filename, as written when a checkpoint file is set on TaskManager
+    //! \details Requires constraints to be set, with the same search space and concurrency as when the checkpoint was written.
+    //! The scores of the steps of this search are appended to those saved in TaskManager.
+    void restore_checkpoint(String const& filename);
     virtual ~TaskRunnable() = default;
   protected:
     TaskRunnable(ConfigurationType const& configuration);
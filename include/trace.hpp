@@ -0,0 +1,106 @@
+/***************************************************************************
+ *            trace.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/*! \file trace.hpp
+ *  \brief Classes for recording the execution of tasks during a parameter search.
+ */
+
+#ifndef PEXPLORE_TRACE_HPP
+#define PEXPLORE_TRACE_HPP
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include "helper/container.hpp"
+#include "helper/string.hpp"
+#include "helper/writable.hpp"
+#include "score.hpp"
+
+namespace pExplore {
+
+using Helper::List;
+using Helper::String;
+using Helper::WritableInterface;
+
+//! \brief The outcome of running the task on a point at a given step
+struct TraceEntry : public WritableInterface {
+    TraceEntry(List<int> const& coordinates_, size_t step_, double latency_, Score const& score_)
+        : coordinates(coordinates_), step(step_), latency(latency_), score(score_) { }
+    List<int> coordinates;
+    size_t step;
+    //! \brief The wall-clock duration of the task, in seconds
+    double latency;
+    Score score;
+
+    ostream& _write(ostream& os) const override;
+};
+
+//! \brief A collection of trace entries, which can be saved to and loaded from a text file
+class ExecutionTrace {
+  public:
+    ExecutionTrace() = default;
+
+    //! \brief Load the trace written in \a filename by save() or by TraceRecorder
+    //! \details Throws std::runtime_error if the file cannot be read or holds an invalid line or value
+    static ExecutionTrace load(String const& filename);
+    void save(String const& filename) const;
+
+    void add(TraceEntry const& entry);
+    List<TraceEntry> const& entries() const;
+    size_t size() const;
+    bool empty() const;
+
+    //! \brief The entry for \a coordinates with the step closest to \a step
+    //! \details If \a coordinates have never been recorded, the entry is taken from the nearest recorded coordinates
+    TraceEntry const& lookup(List<int> const& coordinates, size_t step) const;
+
+  private:
+    List<TraceEntry> _entries;
+    std::map<List<int>,List<size_t>> _indices;
+};
+
+//! \brief Records trace entries into a text file as they happen, from any thread
+class TraceRecorder {
+  public:
+    TraceRecorder(String const& filename);
+    TraceRecorder(TraceRecorder const&) = delete;
+    void operator=(TraceRecorder const&) = delete;
+
+    String const& filename() const;
+    void record(TraceEntry const& entry);
+
+  private:
+    String _filename;
+    std::mutex _mutex;
+    std::ofstream _file;
+};
+
+} // namespace pExplore
+
+#endif // PEXPLORE_TRACE_HPP
@@ -0,0 +1,88 @@
+/***************************************************************************
+ *            visited_points.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file visited_points.hpp
+ *  \brief Class for the memory of the points already visited during exploration.
+ */
+
+#ifndef PEXPLORE_VISITED_POINTS_HPP
+#define PEXPLORE_VISITED_POINTS_HPP
+
+#include <cstdint>
+#include "helper/container.hpp"
+#include "pronest/configuration_search_point.hpp"
+#include "pronest/configuration_search_space.hpp"
+#include "search_point_key.hpp"
+#include "serialisation.hpp"
+
+namespace pExplore {
+
+using Helper::List;
+using ProNest::ConfigurationSearchPoint;
+using ProNest::ConfigurationSearchSpace;
+
+//! \brief Memory of the points visited in a search space, with a bounded footprint
+//! \details If the space has at most \a exact_capacity points, membership is exact;
+//! otherwise a Bloom filter of \a filter_bits bits is used, which may report false positives
+class VisitedPoints {
+  public:
+    VisitedPoints(ConfigurationSearchSpace const& space, size_t exact_capacity = 1<<16, size_t filter_bits = 1<<20);
+
+    //! \brief Whether membership is exact, instead of being probabilistic
+    bool is_exact() const;
+
+    //! \brief Mark \a point as visited
+    void insert(ConfigurationSearchPoint const& point);
+    //! \brief Whether \a point has been visited
+    //! \details False positives are possible if the memory is not exact
+    bool contains(ConfigurationSearchPoint const& point) const;
+
+    //! \brief The number of visited points
+    //! \details An estimate if the memory is not exact
+    size_t size() const;
+
+    void clear();
+
+    //! \brief Write the visited points
+    void save_state(BinaryWriter& writer) const;
+    //! \brief Read the visited points as written by save_state, for a memory built on the same space and sizes
+    void load_state(BinaryReader& reader);
+
+  private:
+    bool _filter_contains(SearchPointKey key) const;
+  private:
+    SearchPointEncoder _encoder;
+    bool _exact;
+    SearchPointKeySet _keys;
+    List<std::uint64_t> _filter_words;
+    size_t _size;
+};
+
+} // namespace pExplore
+
+#endif // PEXPLORE_VISITED_POINTS_HPP
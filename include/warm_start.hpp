@@ -0,0 +1,109 @@
+/***************************************************************************
+ *            warm_start.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file warm_start.hpp
+ *  \brief Classes for persisting the best points of an exploration across process runs.
+ */
+
+#ifndef PEXPLORE_WARM_START_HPP
+#define PEXPLORE_WARM_START_HPP
+
+#include "helper/container.hpp"
+#include "helper/string.hpp"
+#include "helper/writable.hpp"
+#include "pronest/configuration_search_space.hpp"
+#include "score.hpp"
+#include "initialisation.hpp"
+
+namespace pExplore {
+
+using Helper::List;
+using Helper::String;
+using Helper::WritableInterface;
+using ProNest::ConfigurationSearchSpace;
+using std::shared_ptr;
+
+//! \brief The statistics of a point saved in a warm-start store
+struct WarmStartEntry : public WritableInterface {
+    WarmStartEntry(List<int> const& coordinates_, size_t count_, double mean_objective_)
+        : coordinates(coordinates_), count(count_), mean_objective(mean_objective_) { }
+    List<int> coordinates;
+    //! \brief The number of steps where the point was the best
+    size_t count;
+    //! \brief The mean objective of the point when it was the best
+    double mean_objective;
+
+    ostream& _write(ostream& os) const override;
+};
+
+//! \brief A store of the best points of past explorations, persisted as files in a local directory
+//! \details Entries are keyed by a signature of the problem, made of a user tag (e.g., naming the configuration type)
+//! and of the shape of the search space. Saving merges with the existing entries, keeping the \a max_entries most frequent.
+class WarmStartStore {
+  public:
+    WarmStartStore(String const& directory, size_t max_entries = 64);
+
+    String const& directory() const;
+
+    //! \brief The signature of the problem with the given \a space and user \a tag
+    static String signature(ConfigurationSearchSpace const& space, String const& tag);
+
+    //! \brief Merge the statistics of \a best_scores into the entries for \a tag
+    void save(String const& tag, List<PointScore> const& best_scores) const;
+    //! \brief Load the entries for \a space and \a tag, most frequent first
+    //! \details Returns an empty list if nothing has been saved yet
+    List<WarmStartEntry> load(ConfigurationSearchSpace const& space, String const& tag) const;
+
+  private:
+    String _file_for(String const& signature) const;
+    List<WarmStartEntry> _load(String const& signature) const;
+  private:
+    String _directory;
+    size_t _max_entries;
+};
+
+//! \brief Starts from the points saved in a warm-start store, filling any remaining point from another initialisation
+class WarmStartInitialisation : public InitialisationInterface {
+  public:
+    WarmStartInitialisation(WarmStartStore const& store, String const& tag, InitialisationInterface const& fallback = RandomShiftInitialisation());
+
+    Set<ConfigurationSearchPoint> initial_points(ConfigurationSearchPoint const& initial_point, size_t size) override;
+    void set_seed(std::uint64_t seed) override;
+    void save_state(BinaryWriter& writer) const override;
+    void load_state(BinaryReader& reader) override;
+    InitialisationInterface* clone() const override;
+  private:
+    WarmStartStore _store;
+    String _tag;
+    shared_ptr<InitialisationInterface> _fallback;
+    RandomGenerator _generator;
+};
+
+} // namespace pExplore
+
+#endif // PEXPLORE_WARM_START_HPP
@@ -0,0 +1,203 @@
+/***************************************************************************
+ *            affinity.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <cctype>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <tuple>
+#include "helper/macros.hpp"
+#include "affinity.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace pExplore {
+
+namespace {
+
+std::optional<size_t> read_index(std::filesystem::path const& path) {
+    std::ifstream file(path);
+    long long result;
+    if (not (file >> result) or result < 0) return std::nullopt;
+    return static_cast<size_t>(result);
+}
+
+//! \brief The NUMA node of the processor in \a directory, as given by its nodeN entry, or 0 if not exposed
+size_t numa_node(std::filesystem::path const& directory) {
+    std::error_code ec;
+    for (auto const& entry : std::filesystem::directory_iterator(directory,ec)) {
+        auto name = entry.path().filename().string();
+        if (name.size() > 4 and name.substr(0,4) == "node" and std::all_of(name.begin()+4,name.end(),[](char c){ return std::isdigit(static_cast<unsigned char>(c)); }))
+            return static_cast<size_t>(std::stoul(name.substr(4)));
+    }
+    return 0;
+}
+
+}
+
+List<size_t> parse_processor_list(String const& text) {
+    List<size_t> result;
+    std::istringstream stream(text);
+    String range;
+    while (std::getline(stream,range,',')) {
+        range.erase(std::remove_if(range.begin(),range.end(),[](char c){ return std::isspace(static_cast<unsigned char>(c)); }),range.end());
+        if (range.empty()) continue;
+        auto dash = range.find('-');
+        try {
+            size_t first = std::stoul(range.substr(0,dash));
+            size_t last = (dash == String::npos ? first : std::stoul(range.substr(dash+1)));
+            for (size_t cpu = first; cpu <= last; ++cpu) result.push_back(cpu);
+        } catch (std::logic_error const&) {
+            throw std::invalid_argument("Malformed processor list '" + text + "'");
+        }
+    }
+    return result;
+}
+
+List<ProcessorLocation> read_processor_topology(String const& root) {
+    List<ProcessorLocation> result;
+    std::ifstream online_file(std::filesystem::path(root) / "online");
+    String online;
+    if (not std::getline(online_file,online)) return result;
+
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    bool has_mask = (sched_getaffinity(0,sizeof(mask),&mask) == 0);
+#endif
+
+    for (auto cpu : parse_processor_list(online)) {
+#if defined(__linux__)
+        if (has_mask and cpu < CPU_SETSIZE and not CPU_ISSET(cpu,&mask)) continue;
+#endif
+        auto directory = std::filesystem::path(root) / ("cpu" + std::to_string(cpu));
+        auto package = read_index(directory / "topology" / "physical_package_id");
+        auto core = read_index(directory / "topology" / "core_id");
+        result.push_back({cpu,package.value_or(0),core.value_or(cpu),numa_node(directory)});
+    }
+    return result;
+}
+
+bool pin_current_thread([[maybe_unused]] size_t cpu) {
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) return false;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu,&mask);
+    return pthread_setaffinity_np(pthread_self(),sizeof(mask),&mask) == 0;
+#else
+    return false;
+#endif
+}
+
+AffinityPolicy::AffinityPolicy(Kind kind, List<size_t> const& cpus) : _kind(kind), _cpus(cpus) { }
+
+AffinityPolicy AffinityPolicy::none() { return {Kind::NONE,{}}; }
+
+AffinityPolicy AffinityPolicy::compact() { return {Kind::COMPACT,{}}; }
+
+AffinityPolicy AffinityPolicy::scatter() { return {Kind::SCATTER,{}}; }
+
+AffinityPolicy AffinityPolicy::explicit_cpus(List<size_t> const& cpus) {
+    HELPER_PRECONDITION(not cpus.empty())
+    return {Kind::EXPLICIT,cpus};
+}
+
+AffinityPolicy::Kind AffinityPolicy::kind() const {
+    return _kind;
+}
+
+List<size_t> AffinityPolicy::assign(List<ProcessorLocation> const& topology, size_t num_threads) const {
+    List<size_t> order;
+    switch (_kind) {
+        case Kind::NONE:
+            return {};
+        case Kind::EXPLICIT:
+            order = _cpus;
+            break;
+        case Kind::COMPACT: {
+            auto locations = topology;
+            // The first hardware thread of each core comes first, so that threads share a core only when all cores are taken
+            std::stable_sort(locations.begin(),locations.end(),[](ProcessorLocation const& a, ProcessorLocation const& b) {
+                return std::tie(a.package,a.core,a.cpu) < std::tie(b.package,b.core,b.cpu); });
+            List<ProcessorLocation> siblings;
+            for (size_t i = 0; i < locations.size(); ++i) {
+                if (i > 0 and locations[i].package == locations[i-1].package and locations[i].core == locations[i-1].core) siblings.push_back(locations[i]);
+                else order.push_back(locations[i].cpu);
+            }
+            for (auto const& l : siblings) order.push_back(l.cpu);
+            break;
+        }
+        case Kind::SCATTER: {
+            auto locations = topology;
+            std::stable_sort(locations.begin(),locations.end(),[](ProcessorLocation const& a, ProcessorLocation const& b) {
+                return std::tie(a.package,a.core,a.cpu) < std::tie(b.package,b.core,b.cpu); });
+            // Rank each processor by its hardware thread within the core and its core within the package, then interleave packages
+            List<std::tuple<size_t,size_t,size_t,size_t>> ranked;
+            size_t thread_rank = 0, core_rank = 0;
+            for (size_t i = 0; i < locations.size(); ++i) {
+                if (i == 0 or locations[i].package != locations[i-1].package) { core_rank = 0; thread_rank = 0; }
+                else if (locations[i].core != locations[i-1].core) { ++core_rank; thread_rank = 0; }
+                else ++thread_rank;
+                ranked.push_back({thread_rank,core_rank,locations[i].package,locations[i].cpu});
+            }
+            std::stable_sort(ranked.begin(),ranked.end());
+            for (auto const& r : ranked) order.push_back(std::get<3>(r));
+            break;
+        }
+        default:
+            HELPER_FAIL_MSG("Unhandled affinity policy kind for assignment.")
+    }
+    if (order.empty()) return {};
+    List<size_t> result;
+    for (size_t i = 0; i < num_threads; ++i) result.push_back(order[i % order.size()]);
+    return result;
+}
+
+std::optional<size_t> AffinityPolicy::processor_for(List<ProcessorLocation> const& topology, size_t thread) const {
+    auto cpus = assign(topology,thread+1);
+    if (cpus.empty()) return std::nullopt;
+    return cpus.back();
+}
+
+std::ostream& AffinityPolicy::_write(std::ostream& os) const {
+    switch (_kind) {
+        case Kind::NONE: return os << "none";
+        case Kind::COMPACT: return os << "compact";
+        case Kind::SCATTER: return os << "scatter";
+        case Kind::EXPLICIT: return os << "explicit" << _cpus;
+        default: HELPER_FAIL_MSG("Unhandled affinity policy kind for writing.")
+    }
+}
+
+} // namespace pExplore
@@ -0,0 +1,183 @@
+/***************************************************************************
+ *            checkpoint.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include "helper/macros.hpp"
+#include "conclog/logging.hpp"
+#include "serialisation.hpp"
+#include "checkpoint.hpp"
+
+namespace pExplore {
+
+using ConcLog::Logger;
+
+CheckpointWriter::CheckpointWriter(String const& filename)
+    : _filename(filename), _has_pending(false), _reset_pending(false), _writing(false), _terminate(false),
+      _unwritten_steps(0), _history_steps(0), _history_size(0),
+      _thread([this]() { _loop(); }, "ckpt", false) {
+    _thread.activate();
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _terminate = true;
+    }
+    _availability.notify_all();
+}
+
+String const& CheckpointWriter::filename() const {
+    return _filename;
+}
+
+String CheckpointWriter::history_filename(String const& filename) {
+    return filename + ".history";
+}
+
+void CheckpointWriter::write(String const& state, List<PointScore> const& step_scores) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pending = state;
+        _pending_scores.push_back(step_scores);
+        _has_pending = true;
+    }
+    _availability.notify_all();
+}
+
+void CheckpointWriter::reset_history(List<List<PointScore>> const& history) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pending_scores = history;
+    _reset_pending = true;
+}
+
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> locker(_mutex);
+    _completion.wait(locker, [this]() { return not _has_pending and not _writing; });
+}
+
+void CheckpointWriter::_loop() {
+    while (true) {
+        std::unique_lock<std::mutex> locker(_mutex);
+        _availability.wait(locker, [this]() { return _has_pending or _terminate; });
+        if (not _has_pending) break;
+        String state;
+        List<List<PointScore>> scores;
+        std::swap(state,_pending);
+        std::swap(scores,_pending_scores);
+        bool reset = _reset_pending;
+        _has_pending = false;
+        _reset_pending = false;
+        _writing = true;
+        locker.unlock();
+
+        if (reset) {
+            _unwritten_history.clear();
+            _unwritten_steps = 0;
+            _history_steps = 0;
+            _history_size = 0;
+        }
+        BinaryWriter history;
+        for (auto const& step_scores : scores) {
+            history.write<std::uint64_t>(step_scores.size());
+            for (auto const& s : step_scores) write_point_score(history,s);
+        }
+        _unwritten_history += history.data();
+        _unwritten_steps += scores.size();
+
+        if (_append_history(_unwritten_history)) {
+            _history_size += _unwritten_history.size();
+            _history_steps += _unwritten_steps;
+            _unwritten_history.clear();
+            _unwritten_steps = 0;
+            BinaryWriter trailer;
+            trailer.write(_history_steps);
+            trailer.write(_history_size);
+            _write_file(state + trailer.data());
+        } else {
+            CONCLOG_PRINTLN_AT(1,"could not append to checkpoint history '" << history_filename(_filename) << "', keeping the previous checkpoint");
+        }
+
+        locker.lock();
+        _writing = false;
+        locker.unlock();
+        _completion.notify_all();
+    }
+}
+
+bool CheckpointWriter::_append_history(String const& history_data) {
+    auto filename = history_filename(_filename);
+    if (_history_size == 0) {
+        // Started anew, so the history of a checkpoint being restored from the same file is replaced atomically
+        auto temporary = filename + ".tmp";
+        std::error_code error;
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(history_data.data(),static_cast<std::streamsize>(history_data.size()));
+        file.close();
+        if (file.good()) std::filesystem::rename(temporary,filename,error);
+        if (not file.good() or error) {
+            std::filesystem::remove(temporary,error);
+            return false;
+        }
+        return true;
+    }
+    // Data past the size recorded in the checkpoint, left by a failed write, is overwritten
+    std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+    if (not file.is_open()) return false;
+    file.seekp(static_cast<std::streamoff>(_history_size));
+    file.write(history_data.data(),static_cast<std::streamsize>(history_data.size()));
+    file.close();
+    return file.good();
+}
+
+void CheckpointWriter::_write_file(String const& data) const {
+    auto temporary = _filename + ".tmp";
+    std::error_code error;
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(data.data(),static_cast<std::streamsize>(data.size()));
+    file.close();
+    if (not file.good()) {
+        CONCLOG_PRINTLN_AT(1,"could not write checkpoint '" << temporary << "', keeping the previous one");
+        std::filesystem::remove(temporary,error);
+        return;
+    }
+    std::filesystem::rename(temporary,_filename,error);
+    if (error) {
+        CONCLOG_PRINTLN_AT(1,"could not replace checkpoint '" << _filename << "': " << error.message() << ", keeping the previous one");
+        std::filesystem::remove(temporary,error);
+    }
+}
+
+String read_binary_file(String const& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (not file.is_open()) throw DeserialisationException("Could not open file '" + filename + "'");
+    return String(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>());
+}
+
+} // namespace pExplore
@@ -0,0 +1,152 @@
+/***************************************************************************
+ *            concurrency.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "concurrency.hpp"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace pExplore {
+
+namespace {
+
+std::optional<long long> parse_integer(String const& text) {
+    std::istringstream stream(text);
+    long long result;
+    if (not (stream >> result)) return std::nullopt;
+    return result;
+}
+
+std::optional<size_t> cpu_limit(long long quota, long long period) {
+    if (quota <= 0 or period <= 0) return std::nullopt;
+    return static_cast<size_t>((quota + period - 1) / period);
+}
+
+#if defined(__linux__)
+
+std::optional<String> read_file(std::filesystem::path const& path) {
+    std::ifstream file(path);
+    if (not file.is_open()) return std::nullopt;
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+//! \brief Update \a result with \a limit, if any
+void restrict(size_t& result, std::optional<size_t> const& limit) {
+    if (limit.has_value()) result = std::min(result,limit.value());
+}
+
+//! \brief The paths of the cgroup of the process, for v2 (the hierarchy with no controllers) and for the v1 cpu controller
+std::pair<String,String> cgroup_paths() {
+    String v2_path, v1_path;
+    std::ifstream file("/proc/self/cgroup");
+    String line;
+    while (std::getline(file,line)) {
+        auto first = line.find(':');
+        auto second = (first == String::npos ? String::npos : line.find(':',first+1));
+        if (second == String::npos) continue;
+        auto controllers = line.substr(first+1,second-first-1);
+        auto path = line.substr(second+1);
+        if (controllers.empty()) v2_path = path;
+        std::istringstream list(controllers);
+        String controller;
+        while (std::getline(list,controller,','))
+            if (controller == "cpu") v1_path = path;
+    }
+    return {v2_path,v1_path};
+}
+
+//! \brief Restrict \a result by the limit of each directory from \a relative within \a root up to \a root, as given by \a limit_of
+template<class F> void restrict_by_hierarchy(size_t& result, std::filesystem::path const& root, String const& relative, F const& limit_of) {
+    if (not std::filesystem::exists(root)) return;
+    // Within a container the cgroup path may not be visible, in which case only the root applies
+    auto directory = (root / std::filesystem::path(relative).relative_path()).lexically_normal();
+    while (true) {
+        restrict(result,limit_of(directory));
+        if (directory == root or directory.parent_path() == directory) break;
+        directory = directory.parent_path();
+    }
+}
+
+#endif
+
+}
+
+std::optional<size_t> cgroup_v2_cpu_limit(String const& cpu_max) {
+    std::istringstream stream(cpu_max);
+    String quota, period;
+    if (not (stream >> quota >> period)) return std::nullopt;
+    if (quota == "max") return std::nullopt;
+    auto q = parse_integer(quota);
+    auto p = parse_integer(period);
+    if (not q.has_value() or not p.has_value()) return std::nullopt;
+    return cpu_limit(q.value(),p.value());
+}
+
+std::optional<size_t> cgroup_v1_cpu_limit(String const& quota, String const& period) {
+    auto q = parse_integer(quota);
+    auto p = parse_integer(period);
+    if (not q.has_value() or not p.has_value()) return std::nullopt;
+    return cpu_limit(q.value(),p.value());
+}
+
+size_t available_concurrency() {
+    size_t result = std::max<size_t>(std::thread::hardware_concurrency(),1);
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0,sizeof(mask),&mask) == 0) {
+        auto count = CPU_COUNT(&mask);
+        if (count > 0) result = std::min(result,static_cast<size_t>(count));
+    }
+
+    auto paths = cgroup_paths();
+    restrict_by_hierarchy(result,"/sys/fs/cgroup",paths.first,[](std::filesystem::path const& directory) {
+        auto content = read_file(directory / "cpu.max");
+        return (content.has_value() ? cgroup_v2_cpu_limit(content.value()) : std::nullopt);
+    });
+    for (auto const& mount : {"/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct"}) {
+        restrict_by_hierarchy(result,mount,paths.second,[](std::filesystem::path const& directory) {
+            auto quota = read_file(directory / "cpu.cfs_quota_us");
+            auto period = read_file(directory / "cpu.cfs_period_us");
+            return (quota.has_value() and period.has_value() ? cgroup_v1_cpu_limit(quota.value(),period.value()) : std::nullopt);
+        });
+    }
+#endif
+    return std::max<size_t>(result,1);
+}
+
+} // namespace pExplore
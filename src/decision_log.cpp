@@ -0,0 +1,150 @@
+/***************************************************************************
+ *            decision_log.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <sstream>
+#include "helper/macros.hpp"
+#include "search_point_key.hpp"
+#include "decision_log.hpp"
+
+namespace pExplore {
+
+namespace {
+const String DECISION_LOG_HEADER = "pexplore-decisions 1";
+
+DecisionKind kind_from(String const& name) {
+    if (name == "INITIAL") return DecisionKind::INITIAL;
+    if (name == "CONTEXTUALISED") return DecisionKind::CONTEXTUALISED;
+    if (name == "SCREENED") return DecisionKind::SCREENED;
+    if (name == "NEXT") return DecisionKind::NEXT;
+    if (name == "RESIZED") return DecisionKind::RESIZED;
+    throw DecisionReplayException("Unknown decision kind '" + name + "'");
+}
+
+int coordinate_from(String const& value, String const& filename) {
+    try {
+        size_t parsed = 0;
+        auto result = std::stoi(value,&parsed);
+        if (parsed == value.size()) return result;
+    } catch (std::logic_error&) { }
+    throw DecisionReplayException("Invalid coordinate '" + value + "' in decision log '" + filename + "'");
+}
+}
+
+ostream& operator<<(ostream& os, DecisionKind kind) {
+    switch (kind) {
+        case DecisionKind::INITIAL: return os << "INITIAL";
+        case DecisionKind::CONTEXTUALISED: return os << "CONTEXTUALISED";
+        case DecisionKind::SCREENED: return os << "SCREENED";
+        case DecisionKind::NEXT: return os << "NEXT";
+        case DecisionKind::RESIZED: return os << "RESIZED";
+        default: HELPER_FAIL_MSG("Unhandled DecisionKind value")
+    }
+}
+
+DecisionLog::DecisionLog(String const& filename, Mode mode) : _filename(filename), _mode(mode), _next(0) {
+    if (mode == Mode::RECORD) {
+        _file.open(filename, std::ios::trunc);
+        if (not _file.is_open()) throw std::runtime_error("Could not open decision log '" + filename + "' for writing");
+        _file << DECISION_LOG_HEADER << std::endl;
+        return;
+    }
+    std::ifstream file(filename);
+    if (not file.is_open()) throw DecisionReplayException("Could not open decision log '" + filename + "'");
+    String line;
+    std::getline(file,line);
+    if (line != DECISION_LOG_HEADER) throw DecisionReplayException("File '" + filename + "' is not a decision log");
+    while (std::getline(file,line)) {
+        std::istringstream ls(line);
+        String token;
+        if (not (ls >> token)) continue;
+        auto kind = kind_from(token);
+        List<List<int>> points;
+        while (ls >> token) {
+            List<int> coordinates;
+            std::istringstream ts(token);
+            String value;
+            while (std::getline(ts,value,',')) coordinates.push_back(coordinate_from(value,filename));
+            points.push_back(coordinates);
+        }
+        _decisions.push_back({kind,points});
+    }
+}
+
+String const& DecisionLog::filename() const {
+    return _filename;
+}
+
+auto DecisionLog::mode() const -> Mode {
+    return _mode;
+}
+
+bool DecisionLog::is_replaying() const {
+    return _mode == Mode::REPLAY;
+}
+
+void DecisionLog::record(DecisionKind kind, Set<ConfigurationSearchPoint> const& points) {
+    HELPER_PRECONDITION(_mode == Mode::RECORD)
+    _file << kind;
+    for (auto const& p : points) {
+        auto coordinates = p.coordinates();
+        _file << " ";
+        for (size_t i=0; i<coordinates.size(); ++i) _file << (i > 0 ? "," : "") << coordinates[i];
+    }
+    _file << std::endl;
+    ++_next;
+}
+
+Set<ConfigurationSearchPoint> DecisionLog::replay(DecisionKind kind, ConfigurationSearchSpace const& space) {
+    HELPER_PRECONDITION(_mode == Mode::REPLAY)
+    if (_next >= _decisions.size()) {
+        std::ostringstream ss;
+        ss << "Decision log '" << _filename << "' exhausted after " << _decisions.size() << " decisions, while replaying " << kind;
+        throw DecisionReplayException(ss.str());
+    }
+    auto const& decision = _decisions[_next];
+    if (decision.first != kind) {
+        std::ostringstream ss;
+        ss << "Decision " << _next << " in '" << _filename << "' is " << decision.first << ", while replaying " << kind;
+        throw DecisionReplayException(ss.str());
+    }
+    Set<ConfigurationSearchPoint> result;
+    for (auto const& coordinates : decision.second) {
+        if (coordinates.size() != space.dimension())
+            throw DecisionReplayException("Decision " + std::to_string(_next) + " in '" + _filename + "' does not match the space dimension");
+        result.insert(make_point_from_coordinates(space,coordinates));
+    }
+    ++_next;
+    return result;
+}
+
+size_t DecisionLog::size() const {
+    return (_mode == Mode::RECORD ? _next : _decisions.size()-_next);
+}
+
+} // namespace pExplore
@@ -26,25 +26,520 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <numeric>
+#include "helper/macros.hpp"
+#include "conclog/logging.hpp"
 #include "exploration.hpp"
 
 namespace pExplore {
 
-Set<ConfigurationSearchPoint> ShiftAndKeepBestHalfExploration::next_points_from(Set<PointScore> const& scores) const {
+using ConcLog::Logger;
+
+namespace {
+//! \brief How many shifted candidates to generate for each point to fill
+const size_t SHIFTED_CANDIDATES_MULTIPLIER = 4;
+}
+
+ShiftAndKeepBestHalfExploration::ShiftAndKeepBestHalfExploration() : _generator(make_random_seed()) { }
+
+Set<ConfigurationSearchPoint> ShiftAndKeepBestHalfExploration::next_points_from(List<PointScore> const& scores) {
+    HELPER_PRECONDITION(not scores.empty())
+    auto const& space = scores.front().point().space();
+    if (_visited == nullptr) _visited.reset(new VisitedPoints(space));
+    for (auto const& s : scores) _visited->insert(s.point());
+
     Set<ConfigurationSearchPoint> result;
-    size_t cnt = 0;
-    for (auto const& s : scores) {
-        result.insert(s.point());
-        ++cnt;
-        if (cnt >= scores.size()/2) break;
+    for (auto idx : best_score_indices(scores, std::max<size_t>(scores.size()/2,1)))
+        result.insert(scores.at(idx).point());
+
+    auto size = scores.size();
+    auto num_candidates = std::min(space.total_points(), result.size() + SHIFTED_CANDIDATES_MULTIPLIER*(size-result.size()));
+    auto candidates = make_extended_set_by_shifting(result,num_candidates,_generator);
+    List<ConfigurationSearchPoint> unvisited;
+    List<ConfigurationSearchPoint> visited;
+    for (auto const& c : candidates) {
+        if (result.contains(c)) continue;
+        if (_visited->contains(c)) visited.push_back(c);
+        else unvisited.push_back(c);
+    }
+    std::shuffle(unvisited.begin(),unvisited.end(),_generator);
+    std::shuffle(visited.begin(),visited.end(),_generator);
+    for (auto const& c : unvisited) {
+        if (result.size() >= size) break;
+        result.insert(c);
     }
-    result = make_extended_set_by_shifting(result, scores.size());
+    for (auto const& c : visited) {
+        if (result.size() >= size) break;
+        result.insert(c);
+    }
+    HELPER_ASSERT_EQUAL(result.size(),size)
 
     return result;
 }
 
+shared_ptr<VisitedPoints> const& ShiftAndKeepBestHalfExploration::visited() const {
+    return _visited;
+}
+
+void ShiftAndKeepBestHalfExploration::set_seed(std::uint64_t seed) {
+    _generator.seed(seed);
+}
+
+void ShiftAndKeepBestHalfExploration::save_state(BinaryWriter& writer) const {
+    write_generator(writer,_generator);
+    writer.write(_visited != nullptr);
+    if (_visited != nullptr) _visited->save_state(writer);
+}
+
+void ShiftAndKeepBestHalfExploration::load_state(BinaryReader& reader, ConfigurationSearchSpace const& space) {
+    read_generator(reader,_generator);
+    if (reader.read<bool>()) {
+        _visited.reset(new VisitedPoints(space));
+        _visited->load_state(reader);
+    } else _visited.reset();
+}
+
 ExplorationInterface* ShiftAndKeepBestHalfExploration::clone() const {
     return new ShiftAndKeepBestHalfExploration();
 }
 
+SurrogateModelExploration::SurrogateModelExploration(size_t history_size, double bandwidth, size_t candidates_multiplier)
+    : _history_capacity(history_size), _bandwidth(bandwidth), _candidates_multiplier(candidates_multiplier), _generator(make_random_seed()) {
+    HELPER_PRECONDITION(history_size > 0)
+    HELPER_PRECONDITION(bandwidth > 0)
+    HELPER_PRECONDITION(candidates_multiplier > 0)
+}
+
+List<double> SurrogateModelExploration::_normalised(ConfigurationSearchPoint const& point) const {
+    auto coordinates = point.coordinates();
+    List<double> result;
+    result.reserve(coordinates.size());
+    for (size_t i=0; i<coordinates.size(); ++i)
+        result.push_back((static_cast<double>(coordinates[i])-_offsets[i])/_scales[i]);
+    return result;
+}
+
+std::pair<double,double> SurrogateModelExploration::_predict(List<double> const& x) const {
+    // The prior is a uniformly distributed rank, acting as a single pseudo-observation
+    const double prior_mean = 0.5;
+    const double prior_variance = 1.0/12.0;
+    double weight_sum = 1.0;
+    double weighted_sum = prior_mean;
+    for (auto const& sample : _history) {
+        double distance2 = 0.0;
+        for (size_t i=0; i<x.size(); ++i) {
+            auto d = x[i]-sample.first[i];
+            distance2 += d*d;
+        }
+        auto w = std::exp(-distance2/(2*_bandwidth*_bandwidth));
+        weight_sum += w;
+        weighted_sum += w*sample.second;
+    }
+    // The uncertainty shrinks with the effective number of observations close to x
+    return {weighted_sum/weight_sum,std::sqrt(prior_variance/weight_sum)};
+}
+
+double SurrogateModelExploration::_expected_improvement(List<double> const& x) const {
+    // The best rank is zero by construction, hence improvement is measured against it
+    auto prediction = _predict(x);
+    auto mean = prediction.first;
+    auto deviation = prediction.second;
+    if (deviation <= 0) return std::max(0.0,-mean);
+    auto z = -mean/deviation;
+    auto cdf = 0.5*std::erfc(-z/std::sqrt(2.0));
+    auto pdf = std::exp(-0.5*z*z)/std::sqrt(2*std::numbers::pi);
+    return -mean*cdf + deviation*pdf;
+}
+
+std::pair<double,double> SurrogateModelExploration::predict(ConfigurationSearchPoint const& point) const {
+    HELPER_PRECONDITION(not _offsets.empty())
+    return _predict(_normalised(point));
+}
+
+size_t SurrogateModelExploration::history_size() const {
+    return _history.size();
+}
+
+Set<ConfigurationSearchPoint> SurrogateModelExploration::next_points_from(List<PointScore> const& scores) {
+    HELPER_PRECONDITION(not scores.empty())
+    auto const& space = scores.front().point().space();
+    if (_offsets.empty()) {
+        for (auto const& p : space.parameters()) {
+            auto const& values = p.values();
+            auto minmax = std::minmax_element(values.begin(),values.end());
+            _offsets.push_back(static_cast<double>(*minmax.first));
+            _scales.push_back(std::max(1.0,static_cast<double>(*minmax.second-*minmax.first)));
+        }
+    }
+
+    auto size = scores.size();
+    List<size_t> order;
+    order.resize(size);
+    std::iota(order.begin(),order.end(),0);
+    std::sort(order.begin(),order.end(),[&scores](size_t a, size_t b) { return scores[a] < scores[b]; });
+    for (size_t r=0; r<size; ++r) {
+        auto rank = (size > 1 ? static_cast<double>(r)/static_cast<double>(size-1) : 0.0);
+        _history.emplace_back(_normalised(scores[order[r]].point()),rank);
+    }
+    while (_history.size() > _history_capacity) _history.pop_front();
+
+    Set<ConfigurationSearchPoint> result;
+    auto num_kept = std::max<size_t>(size/2,1);
+    for (size_t r=0; r<num_kept; ++r) result.insert(scores[order[r]].point());
+
+    auto num_candidates = std::min(space.total_points(), result.size() + _candidates_multiplier*(size-result.size()));
+    auto candidates = make_extended_set_by_shifting(result,num_candidates,_generator);
+    List<std::pair<double,ConfigurationSearchPoint>> ranked_candidates;
+    for (auto const& c : candidates) {
+        if (result.contains(c)) continue;
+        ranked_candidates.emplace_back(_expected_improvement(_normalised(c)),c);
+    }
+    std::sort(ranked_candidates.begin(),ranked_candidates.end(),[](auto const& a, auto const& b) { return a.first > b.first; });
+    for (auto const& c : ranked_candidates) {
+        if (result.size() >= size) break;
+        result.insert(c.second);
+    }
+    HELPER_ASSERT_EQUAL(result.size(),size)
+
+    return result;
+}
+
+void SurrogateModelExploration::set_seed(std::uint64_t seed) {
+    _generator.seed(seed);
+}
+
+void SurrogateModelExploration::save_state(BinaryWriter& writer) const {
+    write_generator(writer,_generator);
+    writer.write(_offsets);
+    writer.write(_scales);
+    writer.write<std::uint64_t>(_history.size());
+    for (auto const& sample : _history) {
+        writer.write(sample.first);
+        writer.write(sample.second);
+    }
+}
+
+void SurrogateModelExploration::load_state(BinaryReader& reader, ConfigurationSearchSpace const& space) {
+    read_generator(reader,_generator);
+    _offsets = reader.read_doubles();
+    _scales = reader.read_doubles();
+    if (not _offsets.empty() and (_offsets.size() != space.dimension() or _scales.size() != space.dimension()))
+        throw DeserialisationException("Saved surrogate model does not match the space dimension");
+    _history.clear();
+    auto size = static_cast<size_t>(reader.read<std::uint64_t>());
+    for (size_t i=0; i<size; ++i) {
+        auto x = reader.read_doubles();
+        auto rank = reader.read<double>();
+        _history.emplace_back(x,rank);
+    }
+    while (_history.size() > _history_capacity) _history.pop_front();
+}
+
+ExplorationInterface* SurrogateModelExploration::clone() const {
+    return new SurrogateModelExploration(_history_capacity,_bandwidth,_candidates_multiplier);
+}
+
+PortfolioExploration::PortfolioExploration(double confidence)
+    : _confidence(confidence), _steps(0), _generator(make_random_seed()) {
+    HELPER_PRECONDITION(confidence >= 0)
+}
+
+PortfolioExploration& PortfolioExploration::add(ExplorationInterface const& exploration) {
+    _explorations.push_back(shared_ptr<ExplorationInterface>(exploration.clone()));
+    _reward_sums.push_back(0.0);
+    _rewarded_steps.push_back(0);
+    _allocations.push_back(0);
+    return *this;
+}
+
+size_t PortfolioExploration::size() const {
+    return _explorations.size();
+}
+
+List<double> PortfolioExploration::mean_rewards() const {
+    List<double> result;
+    for (size_t a=0; a<_explorations.size(); ++a)
+        result.push_back(_rewarded_steps[a] > 0 ? _reward_sums[a]/static_cast<double>(_rewarded_steps[a]) : 0.0);
+    return result;
+}
+
+List<size_t> const& PortfolioExploration::allocations() const {
+    return _allocations;
+}
+
+void PortfolioExploration::_update_rewards(List<PointScore> const& scores, Set<ConfigurationSearchPoint> const& kept) {
+    if (_proposers.empty()) return;
+    List<size_t> proposed;
+    List<size_t> hits;
+    proposed.resize(_explorations.size(),0);
+    hits.resize(_explorations.size(),0);
+    for (auto const& s : scores) {
+        auto it = _proposers.find(_encoder->encode(s.point()));
+        if (it == _proposers.end()) continue;
+        ++proposed[it->second];
+        if (kept.contains(s.point())) ++hits[it->second];
+    }
+    for (size_t a=0; a<_explorations.size(); ++a) {
+        if (proposed[a] == 0) continue;
+        _reward_sums[a] += static_cast<double>(hits[a])/static_cast<double>(proposed[a]);
+        ++_rewarded_steps[a];
+    }
+    ++_steps;
+}
+
+List<size_t> PortfolioExploration::_allocate(size_t slots) const {
+    auto num_arms = _explorations.size();
+    List<size_t> result;
+    result.resize(num_arms,0);
+    if (slots == 0) return result;
+
+    // Untried explorations get the highest index, so that they are tried as soon as possible
+    auto means = mean_rewards();
+    List<double> indices;
+    indices.resize(num_arms,0.0);
+    double max_index = 1.0;
+    for (size_t a=0; a<num_arms; ++a) {
+        if (_rewarded_steps[a] > 0) {
+            indices[a] = means[a] + _confidence*std::sqrt(2.0*std::log(static_cast<double>(std::max<size_t>(_steps,1)))/static_cast<double>(_rewarded_steps[a]));
+            max_index = std::max(max_index,indices[a]);
+        }
+    }
+    for (size_t a=0; a<num_arms; ++a)
+        if (_rewarded_steps[a] == 0) indices[a] = max_index;
+
+    size_t remaining = slots;
+    if (slots >= num_arms) {
+        for (auto& r : result) r = 1;
+        remaining -= num_arms;
+    }
+    double index_sum = 0.0;
+    for (auto i : indices) index_sum += i;
+    List<std::pair<double,size_t>> fractions;
+    size_t assigned = 0;
+    for (size_t a=0; a<num_arms; ++a) {
+        auto share = (index_sum > 0 ? static_cast<double>(remaining)*indices[a]/index_sum : static_cast<double>(remaining)/static_cast<double>(num_arms));
+        auto whole = static_cast<size_t>(std::floor(share));
+        result[a] += whole;
+        assigned += whole;
+        fractions.emplace_back(share-static_cast<double>(whole),a);
+    }
+    std::sort(fractions.begin(),fractions.end(),[](auto const& x, auto const& y) { return x.first > y.first; });
+    for (size_t i=0; assigned<remaining; ++i, ++assigned)
+        ++result[fractions[i % num_arms].second];
+    return result;
+}
+
+Set<ConfigurationSearchPoint> PortfolioExploration::next_points_from(List<PointScore> const& scores) {
+    HELPER_PRECONDITION(not scores.empty())
+    HELPER_PRECONDITION(not _explorations.empty())
+    if (_encoder == nullptr) _encoder.reset(new SearchPointEncoder(scores.front().point().space()));
+
+    auto size = scores.size();
+    Set<ConfigurationSearchPoint> kept;
+    for (auto idx : best_score_indices(scores, std::max<size_t>(size/2,1)))
+        kept.insert(scores.at(idx).point());
+    _update_rewards(scores,kept);
+
+    List<List<ConfigurationSearchPoint>> proposals;
+    for (auto& e : _explorations) {
+        List<ConfigurationSearchPoint> proposal;
+        for (auto const& p : e->next_points_from(scores))
+            if (not kept.contains(p)) proposal.push_back(p);
+        std::shuffle(proposal.begin(),proposal.end(),_generator);
+        proposals.push_back(proposal);
+    }
+
+    _allocations = _allocate(size-kept.size());
+    _proposers.clear();
+    Set<ConfigurationSearchPoint> result = kept;
+    List<size_t> taken;
+    taken.resize(_explorations.size(),0);
+    for (size_t a=0; a<_explorations.size(); ++a) {
+        auto& proposal = proposals[a];
+        while (taken[a] < proposal.size() and result.size() < size) {
+            if (_allocations[a] == 0) break;
+            auto const& p = proposal[taken[a]++];
+            if (result.contains(p)) continue;
+            result.insert(p);
+            _proposers.insert({_encoder->encode(p),a});
+            --_allocations[a];
+        }
+    }
+    // Slots not filled by an exploration (e.g., due to overlapping proposals) go to any other exploration
+    for (size_t a=0; a<_explorations.size() and result.size() < size; ++a) {
+        for (size_t i=taken[a]; i<proposals[a].size() and result.size() < size; ++i) {
+            auto const& p = proposals[a][i];
+            if (result.contains(p)) continue;
+            result.insert(p);
+            _proposers.insert({_encoder->encode(p),a});
+        }
+    }
+    if (result.size() < size) result = make_extended_set_by_shifting(result,size,_generator);
+
+    // Report the effective allocations
+    for (auto& n : _allocations) n = 0;
+    for (auto const& p : _proposers) ++_allocations[p.second];
+    HELPER_ASSERT_EQUAL(result.size(),size)
+
+    return result;
+}
+
+void PortfolioExploration::set_seed(std::uint64_t seed) {
+    _generator.seed(seed);
+    for (size_t a=0; a<_explorations.size(); ++a) _explorations[a]->set_seed(derive_seed(seed,a+1));
+}
+
+void PortfolioExploration::save_state(BinaryWriter& writer) const {
+    writer.write<std::uint64_t>(_explorations.size());
+    writer.write(_reward_sums);
+    writer.write(_rewarded_steps);
+    writer.write(_allocations);
+    writer.write<std::uint64_t>(_steps);
+    writer.write<std::uint64_t>(_proposers.size());
+    for (auto const& p : _proposers) {
+        writer.write<std::uint64_t>(p.first);
+        writer.write<std::uint64_t>(p.second);
+    }
+    write_generator(writer,_generator);
+    for (auto const& e : _explorations) e->save_state(writer);
+}
+
+void PortfolioExploration::load_state(BinaryReader& reader, ConfigurationSearchSpace const& space) {
+    auto num_explorations = static_cast<size_t>(reader.read<std::uint64_t>());
+    if (num_explorations != _explorations.size())
+        throw DeserialisationException("Saved portfolio has " + std::to_string(num_explorations) + " explorations, expected " + std::to_string(_explorations.size()));
+    _reward_sums = reader.read_doubles();
+    _rewarded_steps = reader.read_sizes();
+    _allocations = reader.read_sizes();
+    if (_reward_sums.size() != num_explorations or _rewarded_steps.size() != num_explorations or _allocations.size() != num_explorations)
+        throw DeserialisationException("Saved portfolio statistics do not match the number of explorations");
+    _steps = static_cast<size_t>(reader.read<std::uint64_t>());
+    _encoder.reset(new SearchPointEncoder(space));
+    _proposers.clear();
+    auto num_proposers = static_cast<size_t>(reader.read<std::uint64_t>());
+    for (size_t i=0; i<num_proposers; ++i) {
+        auto key = reader.read<std::uint64_t>();
+        auto a = static_cast<size_t>(reader.read<std::uint64_t>());
+        if (a >= num_explorations) throw DeserialisationException("Invalid proposer index " + std::to_string(a));
+        _proposers.insert({key,a});
+    }
+    read_generator(reader,_generator);
+    for (auto& e : _explorations) e->load_state(reader,space);
+}
+
+ExplorationInterface* PortfolioExploration::clone() const {
+    auto result = new PortfolioExploration(_confidence);
+    for (auto const& e : _explorations) result->add(*e);
+    return result;
+}
+
+ContextualExploration::ContextualExploration(ExplorationInterface const& exploration, double radius, size_t max_contexts)
+    : _exploration(exploration.clone()), _radius(radius), _max_contexts(max_contexts), _current(0), _generator(make_random_seed()) {
+    HELPER_PRECONDITION(radius > 0)
+    HELPER_PRECONDITION(max_contexts > 0)
+}
+
+size_t ContextualExploration::num_contexts() const {
+    return _contexts.size();
+}
+
+size_t ContextualExploration::current_context() const {
+    return _current;
+}
+
+size_t ContextualExploration::_context_for(List<double> const& features) {
+    size_t nearest = 0;
+    double nearest_distance = std::numeric_limits<double>::infinity();
+    for (size_t i=0; i<_contexts.size(); ++i) {
+        auto const& centroid = _contexts[i].centroid;
+        HELPER_PRECONDITION(centroid.size() == features.size())
+        double distance2 = 0.0;
+        for (size_t j=0; j<features.size(); ++j) distance2 += (features[j]-centroid[j])*(features[j]-centroid[j]);
+        if (distance2 < nearest_distance) {
+            nearest = i;
+            nearest_distance = distance2;
+        }
+    }
+    if (_contexts.empty() or (std::sqrt(nearest_distance) > _radius and _contexts.size() < _max_contexts)) {
+        _contexts.push_back({features,1,nullptr});
+        return _contexts.size()-1;
+    }
+    auto& context = _contexts[nearest];
+    ++context.count;
+    for (size_t j=0; j<features.size(); ++j)
+        context.centroid[j] += (features[j]-context.centroid[j])/static_cast<double>(context.count);
+    return nearest;
+}
+
+Set<ConfigurationSearchPoint> ContextualExploration::contextualise(List<double> const& features, Set<ConfigurationSearchPoint> const& points) {
+    auto previous = _current;
+    auto first_time = _contexts.empty();
+    _current = _context_for(features);
+    auto const& best_point = _contexts[_current].best_point;
+    if (first_time or _current == previous or best_point == nullptr) return points;
+
+    CONCLOG_PRINTLN_AT(1,"context changed from " << previous << " to " << _current << ", restarting from " << *best_point);
+    auto size = points.size();
+    Set<ConfigurationSearchPoint> result;
+    result.insert(*best_point);
+    auto restarted = std::min(std::max<size_t>(size/2,1),best_point->space().total_points());
+    result = make_extended_set_by_shifting(result,restarted,_generator);
+    for (auto const& p : points) {
+        if (result.size() >= size) break;
+        result.insert(p);
+    }
+    if (result.size() < size) result = make_extended_set_by_shifting(result,size,_generator);
+    return result;
+}
+
+Set<ConfigurationSearchPoint> ContextualExploration::next_points_from(List<PointScore> const& scores) {
+    HELPER_PRECONDITION(not scores.empty())
+    if (not _contexts.empty())
+        _contexts[_current].best_point.reset(new ConfigurationSearchPoint(scores.at(best_score_index(scores)).point()));
+    return _exploration->next_points_from(scores);
+}
+
+void ContextualExploration::set_seed(std::uint64_t seed) {
+    _generator.seed(seed);
+    _exploration->set_seed(derive_seed(seed,1));
+}
+
+void ContextualExploration::save_state(BinaryWriter& writer) const {
+    write_generator(writer,_generator);
+    writer.write<std::uint64_t>(_contexts.size());
+    for (auto const& c : _contexts) {
+        writer.write(c.centroid);
+        writer.write<std::uint64_t>(c.count);
+        writer.write(c.best_point != nullptr);
+        if (c.best_point != nullptr) write_point(writer,*c.best_point);
+    }
+    writer.write<std::uint64_t>(_current);
+    _exploration->save_state(writer);
+}
+
+void ContextualExploration::load_state(BinaryReader& reader, ConfigurationSearchSpace const& space) {
+    read_generator(reader,_generator);
+    _contexts.clear();
+    auto num_contexts = static_cast<size_t>(reader.read<std::uint64_t>());
+    for (size_t i=0; i<num_contexts; ++i) {
+        auto centroid = reader.read_doubles();
+        auto count = static_cast<size_t>(reader.read<std::uint64_t>());
+        shared_ptr<ConfigurationSearchPoint> best_point;
+        if (reader.read<bool>()) best_point.reset(new ConfigurationSearchPoint(read_point(reader,space)));
+        _contexts.push_back({centroid,count,best_point});
+    }
+    _current = static_cast<size_t>(reader.read<std::uint64_t>());
+    if (_current > 0 and _current >= _contexts.size())
+        throw DeserialisationException("Invalid current context " + std::to_string(_current));
+    _exploration->load_state(reader,space);
+}
+
+ExplorationInterface* ContextualExploration::clone() const {
+    return new ContextualExploration(*_exploration,_radius,_max_contexts);
+}
+
 } // namespace pExplore
@@ -0,0 +1,70 @@
+/***************************************************************************
+ *            fidelity.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "helper/macros.hpp"
+#include "helper/string.hpp"
+#include "fidelity.hpp"
+
+namespace pExplore {
+
+SuccessiveHalvingSchedule::SuccessiveHalvingSchedule() : SuccessiveHalvingSchedule(List<double>()) { }
+
+SuccessiveHalvingSchedule::SuccessiveHalvingSchedule(List<double> const& screening_fidelities, size_t reduction_factor)
+    : _fidelities(screening_fidelities), _reduction_factor(reduction_factor) {
+    HELPER_PRECONDITION(reduction_factor > 1)
+    for (size_t i=0; i<_fidelities.size(); ++i) {
+        HELPER_PRECONDITION(_fidelities[i] > 0.0 and _fidelities[i] < 1.0)
+        if (i > 0) HELPER_PRECONDITION(_fidelities[i] > _fidelities[i-1])
+    }
+    _fidelities.push_back(1.0);
+}
+
+bool SuccessiveHalvingSchedule::is_single_fidelity() const {
+    return _fidelities.size() == 1;
+}
+
+size_t SuccessiveHalvingSchedule::num_rungs() const {
+    return _fidelities.size();
+}
+
+double SuccessiveHalvingSchedule::fidelity(size_t rung) const {
+    return _fidelities.at(rung);
+}
+
+size_t SuccessiveHalvingSchedule::rung_size(size_t rung, size_t final_size) const {
+    HELPER_PRECONDITION(rung < _fidelities.size())
+    size_t result = final_size;
+    for (size_t i=rung+1; i<_fidelities.size(); ++i) result *= _reduction_factor;
+    return result;
+}
+
+ostream& SuccessiveHalvingSchedule::_write(ostream& os) const {
+    return os << "{fidelities=" << _fidelities << ", reduction_factor=" << _reduction_factor << "}";
+}
+
+} // namespace pExplore
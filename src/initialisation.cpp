@@ -0,0 +1,124 @@
+/***************************************************************************
+ *            initialisation.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include "helper/macros.hpp"
+#include "pronest/configuration_search_space.hpp"
+#include "search_point_key.hpp"
+#include "initialisation.hpp"
+
+namespace pExplore {
+
+using Helper::List;
+
+RandomShiftInitialisation::RandomShiftInitialisation() : _generator(make_random_seed()) { }
+
+Set<ConfigurationSearchPoint> RandomShiftInitialisation::initial_points(ConfigurationSearchPoint const& initial_point, size_t size) {
+    Set<ConfigurationSearchPoint> result;
+    result.insert(initial_point);
+    return make_extended_set_by_shifting(result,size,_generator);
+}
+
+void RandomShiftInitialisation::set_seed(std::uint64_t seed) {
+    _generator.seed(seed);
+}
+
+void RandomShiftInitialisation::save_state(BinaryWriter& writer) const {
+    write_generator(writer,_generator);
+}
+
+void RandomShiftInitialisation::load_state(BinaryReader& reader) {
+    read_generator(reader,_generator);
+}
+
+InitialisationInterface* RandomShiftInitialisation::clone() const {
+    return new RandomShiftInitialisation();
+}
+
+LatinHypercubeInitialisation::LatinHypercubeInitialisation(bool include_initial_point)
+    : _include_initial_point(include_initial_point), _generator(make_random_seed()) { }
+
+Set<ConfigurationSearchPoint> LatinHypercubeInitialisation::initial_points(ConfigurationSearchPoint const& initial_point, size_t size) {
+    auto const& space = initial_point.space();
+    HELPER_PRECONDITION(size <= space.total_points())
+    auto const& parameters = space.parameters();
+    std::uniform_real_distribution<double> offset_distribution(0.0,1.0);
+
+    auto initial_coordinates = initial_point.coordinates();
+    List<List<int>> strata;
+    for (size_t i=0; i<parameters.size(); ++i) {
+        auto values = parameters[i].values();
+        std::sort(values.begin(),values.end());
+        List<int> column;
+        column.reserve(size);
+        for (size_t j=0; j<size; ++j) {
+            auto u = (static_cast<double>(j) + offset_distribution(_generator))/static_cast<double>(size);
+            auto idx = std::min(static_cast<size_t>(u*static_cast<double>(values.size())),values.size()-1);
+            column.push_back(values[idx]);
+        }
+        if (_include_initial_point) {
+            // The initial point takes the first sample, replacing the one of its stratum, so that each stratum is still covered once
+            auto position = static_cast<size_t>(std::lower_bound(values.begin(),values.end(),initial_coordinates[i])-values.begin());
+            auto stratum = std::min(static_cast<size_t>((static_cast<double>(position)+0.5)*static_cast<double>(size)/static_cast<double>(values.size())),size-1);
+            column[stratum] = column[0];
+            column[0] = initial_coordinates[i];
+            std::shuffle(column.begin()+1,column.end(),_generator);
+        } else {
+            std::shuffle(column.begin(),column.end(),_generator);
+        }
+        strata.push_back(column);
+    }
+
+    Set<ConfigurationSearchPoint> result;
+    for (size_t j=0; j<size; ++j) {
+        List<int> coordinates;
+        coordinates.reserve(parameters.size());
+        for (auto const& column : strata) coordinates.push_back(column[j]);
+        result.insert(make_point_from_coordinates(space,coordinates));
+    }
+    if (result.size() < size) result = make_extended_set_by_shifting(result,size,_generator);
+    return result;
+}
+
+void LatinHypercubeInitialisation::set_seed(std::uint64_t seed) {
+    _generator.seed(seed);
+}
+
+void LatinHypercubeInitialisation::save_state(BinaryWriter& writer) const {
+    write_generator(writer,_generator);
+}
+
+void LatinHypercubeInitialisation::load_state(BinaryReader& reader) {
+    read_generator(reader,_generator);
+}
+
+InitialisationInterface* LatinHypercubeInitialisation::clone() const {
+    return new LatinHypercubeInitialisation(_include_initial_point);
+}
+
+} // namespace pExplore
@@ -0,0 +1,462 @@
+/***************************************************************************
+ *            island.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "island.hpp"
+
+#if defined(PEXPLORE_HAS_ISLANDS)
+
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "helper/macros.hpp"
+#include "conclog/logging.hpp"
+#include "serialisation.hpp"
+
+using ConcLog::Logger;
+
+namespace pExplore {
+
+namespace {
+
+//! \brief Identifies a frame of an island message, along with its format version
+const std::uint32_t ISLAND_MAGIC = 0x7045584d;
+const std::uint32_t ISLAND_VERSION = 1;
+//! \brief The size of the frame header, with the magic number, the version and the payload size
+const size_t ISLAND_HEADER_SIZE = 2*sizeof(std::uint32_t) + sizeof(std::uint64_t);
+//! \brief The maximum payload accepted, to protect against malformed frames
+const std::uint64_t ISLAND_MAX_PAYLOAD = 1 << 24;
+//! \brief How long a connection may block when sending or receiving
+const long ISLAND_TIMEOUT_MILLISECONDS = 1000;
+//! \brief How often the listening thread checks for termination
+const int ISLAND_POLL_MILLISECONDS = 100;
+
+String const UNIX_PREFIX = "unix:";
+String const TCP_PREFIX = "tcp:";
+
+std::system_error system_error(char const* what) {
+    return std::system_error(errno,std::generic_category(),what);
+}
+
+bool is_unix(String const& address) {
+    return address.starts_with(UNIX_PREFIX);
+}
+
+//! \brief The path of a "unix:" \a address
+String unix_path(String const& address) {
+    auto path = address.substr(UNIX_PREFIX.size());
+    HELPER_PRECONDITION(not path.empty())
+    HELPER_PRECONDITION(path.size() < sizeof(sockaddr_un::sun_path))
+    return path;
+}
+
+sockaddr_un unix_socket_address(String const& address) {
+    sockaddr_un result;
+    std::memset(&result,0,sizeof(result));
+    result.sun_family = AF_UNIX;
+    auto path = unix_path(address);
+    std::memcpy(result.sun_path,path.data(),path.size());
+    return result;
+}
+
+//! \brief The host and port of a "tcp:" \a address
+std::pair<String,String> tcp_host_port(String const& address) {
+    HELPER_PRECONDITION(address.starts_with(TCP_PREFIX))
+    auto host_port = address.substr(TCP_PREFIX.size());
+    auto separator = host_port.rfind(':');
+    HELPER_PRECONDITION(separator != String::npos and separator > 0 and separator+1 < host_port.size())
+    return {host_port.substr(0,separator),host_port.substr(separator+1)};
+}
+
+//! \brief Call \a f on each socket address resolved for a "tcp:" \a address, until it returns a valid descriptor
+template<class F> int for_tcp_addresses(String const& address, bool passive, F const& f) {
+    auto host_port = tcp_host_port(address);
+    addrinfo hints;
+    std::memset(&hints,0,sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (passive) hints.ai_flags = AI_PASSIVE;
+    addrinfo* infos = nullptr;
+    if (getaddrinfo(host_port.first.c_str(),host_port.second.c_str(),&hints,&infos) != 0) return -1;
+    int result = -1;
+    for (auto info = infos; info != nullptr and result < 0; info = info->ai_next) result = f(*info);
+    freeaddrinfo(infos);
+    return result;
+}
+
+void set_timeouts(int fd) {
+    timeval timeout;
+    timeout.tv_sec = ISLAND_TIMEOUT_MILLISECONDS/1000;
+    timeout.tv_usec = (ISLAND_TIMEOUT_MILLISECONDS%1000)*1000;
+    setsockopt(fd,SOL_SOCKET,SO_RCVTIMEO,&timeout,sizeof(timeout));
+    setsockopt(fd,SOL_SOCKET,SO_SNDTIMEO,&timeout,sizeof(timeout));
+#if defined(SO_NOSIGPIPE)
+    int on = 1;
+    setsockopt(fd,SOL_SOCKET,SO_NOSIGPIPE,&on,sizeof(on));
+#endif
+}
+
+//! \brief A socket address to connect to
+struct SocketAddress {
+    int family;
+    sockaddr_storage storage;
+    socklen_t size;
+};
+
+//! \brief The socket addresses for \a address, empty if it cannot be resolved
+List<SocketAddress> resolve(String const& address) {
+    List<SocketAddress> result;
+    SocketAddress socket_address;
+    std::memset(&socket_address,0,sizeof(socket_address));
+    if (is_unix(address)) {
+        auto unix_address = unix_socket_address(address);
+        socket_address.family = AF_UNIX;
+        std::memcpy(&socket_address.storage,&unix_address,sizeof(unix_address));
+        socket_address.size = sizeof(unix_address);
+        result.push_back(socket_address);
+        return result;
+    }
+    for_tcp_addresses(address,false,[&](addrinfo const& info) {
+        if (info.ai_addrlen > sizeof(socket_address.storage)) return -1;
+        socket_address.family = info.ai_family;
+        std::memcpy(&socket_address.storage,info.ai_addr,info.ai_addrlen);
+        socket_address.size = info.ai_addrlen;
+        result.push_back(socket_address);
+        // All addresses are kept, to be tried in turn when connecting
+        return -1;
+    });
+    return result;
+}
+
+//! \brief Connect to the first reachable of \a socket_addresses, returning the descriptor or -1 if none is reachable
+int connect_to(List<SocketAddress> const& socket_addresses) {
+    for (auto const& a : socket_addresses) {
+        auto fd = socket(a.family,SOCK_STREAM,0);
+        if (fd < 0) continue;
+        set_timeouts(fd);
+        if (connect(fd,reinterpret_cast<sockaddr const*>(&a.storage),a.size) == 0) return fd;
+        close(fd);
+    }
+    return -1;
+}
+
+bool write_all(int fd, char const* data, size_t size) {
+#if defined(MSG_NOSIGNAL)
+    int flags = MSG_NOSIGNAL;
+#else
+    int flags = 0;
+#endif
+    while (size > 0) {
+        auto written = ::send(fd,data,size,flags);
+        if (written < 0 and errno == EINTR) continue;
+        if (written <= 0) return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool read_all(int fd, char* data, size_t size) {
+    while (size > 0) {
+        auto num_read = recv(fd,data,size,0);
+        if (num_read < 0 and errno == EINTR) continue;
+        if (num_read <= 0) return false;
+        data += num_read;
+        size -= static_cast<size_t>(num_read);
+    }
+    return true;
+}
+
+}
+
+struct IslandChannel::Peer {
+    String address;
+    List<SocketAddress> socket_addresses; // Empty until resolved
+};
+
+IslandChannel::Listener::~Listener() {
+    if (fd >= 0) close(fd);
+    if (not path.empty()) unlink(path.c_str());
+}
+
+IslandChannel::Wakeup::~Wakeup() {
+    for (auto fd : fds) if (fd >= 0) close(fd);
+}
+
+IslandChannel::IslandChannel(String const& address)
+    : _address(address), _num_sending(0), _terminate(false) {
+    if (pipe(_wakeup.fds) != 0) throw system_error("pipe");
+    // Writing never blocks the caller, a full pipe waking up the thread anyway, and reading drains the pipe
+    for (auto fd : _wakeup.fds) fcntl(fd,F_SETFL,fcntl(fd,F_GETFL) | O_NONBLOCK);
+    if (is_unix(address)) {
+        _listener.fd = socket(AF_UNIX,SOCK_STREAM,0);
+        if (_listener.fd < 0) throw system_error("socket");
+        auto socket_address = unix_socket_address(address);
+        // An existing file is not removed, since it may belong to a live island
+        if (bind(_listener.fd,reinterpret_cast<sockaddr const*>(&socket_address),sizeof(socket_address)) != 0) throw system_error("bind");
+        _listener.path = unix_path(address);
+    } else {
+        _listener.fd = for_tcp_addresses(address,true,[](addrinfo const& info) {
+            auto fd = socket(info.ai_family,info.ai_socktype,info.ai_protocol);
+            if (fd < 0) return -1;
+            int on = 1;
+            setsockopt(fd,SOL_SOCKET,SO_REUSEADDR,&on,sizeof(on));
+            if (bind(fd,info.ai_addr,info.ai_addrlen) != 0) {
+                close(fd);
+                return -1;
+            }
+            return fd;
+        });
+        if (_listener.fd < 0) throw std::runtime_error("Could not listen at '" + address + "'");
+        sockaddr_storage bound;
+        socklen_t bound_size = sizeof(bound);
+        char port[NI_MAXSERV];
+        if (getsockname(_listener.fd,reinterpret_cast<sockaddr*>(&bound),&bound_size) == 0 and
+            getnameinfo(reinterpret_cast<sockaddr const*>(&bound),bound_size,nullptr,0,port,sizeof(port),NI_NUMERICSERV) == 0)
+            _address = TCP_PREFIX + tcp_host_port(address).first + ":" + port;
+    }
+    if (listen(_listener.fd,SOMAXCONN) != 0) throw system_error("listen");
+    _thread.reset(new Thread([this]() { _loop(); }, "isle", false));
+    _thread->activate();
+}
+
+IslandChannel::~IslandChannel() {
+    // The thread must terminate before the listener is closed
+    _terminate = true;
+    _wake_up();
+    _thread.reset();
+}
+
+String const& IslandChannel::address() const {
+    return _address;
+}
+
+void IslandChannel::add_peer(String const& address) {
+    HELPER_PRECONDITION(is_unix(address) or address.starts_with(TCP_PREFIX))
+    auto peer = std::make_shared<Peer>(Peer{address,resolve(address)});
+    if (peer->socket_addresses.empty()) CONCLOG_PRINTLN_AT(1,"island " << address << " cannot be resolved yet");
+    std::lock_guard<std::mutex> lock(_peers_mutex);
+    _peers.push_back(peer);
+}
+
+List<String> IslandChannel::peers() const {
+    List<String> result;
+    std::lock_guard<std::mutex> lock(_peers_mutex);
+    for (auto const& peer : _peers) result.push_back(peer->address);
+    return result;
+}
+
+void IslandChannel::send(List<PointScore> const& scores) {
+    BinaryWriter payload;
+    payload.write(_address);
+    payload.write<std::uint64_t>(scores.size());
+    for (auto const& s : scores) write_point_score(payload,s);
+    BinaryWriter frame;
+    frame.write(ISLAND_MAGIC);
+    frame.write(ISLAND_VERSION);
+    frame.write<std::uint64_t>(payload.data().size());
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _outgoing.push_back(frame.data() + payload.data());
+    }
+    _wake_up();
+}
+
+size_t IslandChannel::num_queued() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _outgoing.size() + _num_sending;
+}
+
+List<PointScore> IslandChannel::receive(ConfigurationSearchSpace const& space) {
+    List<String> payloads;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(payloads,_payloads);
+    }
+    List<PointScore> result;
+    for (auto const& payload : payloads) {
+        try {
+            BinaryReader reader(payload);
+            auto sender = reader.read_string();
+            auto num_scores = static_cast<size_t>(reader.read<std::uint64_t>());
+            List<PointScore> scores;
+            for (size_t i=0; i<num_scores; ++i) scores.push_back(read_point_score(reader,space));
+            CONCLOG_PRINTLN_AT(1,"received " << num_scores << " scores from island " << sender);
+            for (auto const& s : scores) result.push_back(s);
+        } catch (std::exception& e) {
+            // Messages come from outside the process, hence any invalid content only discards them
+            CONCLOG_PRINTLN_AT(1,"discarded island message: " << e.what());
+        }
+    }
+    return result;
+}
+
+size_t IslandChannel::num_pending() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _payloads.size();
+}
+
+void IslandChannel::_wake_up() {
+    char byte = 0;
+    [[maybe_unused]] auto written = write(_wakeup.fds[1],&byte,1);
+}
+
+void IslandChannel::_loop() {
+    while (not _terminate) {
+        pollfd fds[2] = {{_listener.fd,POLLIN,0},{_wakeup.fds[0],POLLIN,0}};
+        if (poll(fds,2,ISLAND_POLL_MILLISECONDS) > 0) {
+            char bytes[64];
+            if (fds[1].revents & POLLIN) while (read(_wakeup.fds[0],bytes,sizeof(bytes)) > 0) { }
+            if (fds[0].revents & POLLIN) _accept();
+        }
+        _send_queued();
+    }
+    // Messages queued before destruction are still sent
+    _send_queued();
+}
+
+void IslandChannel::_send_queued() {
+    List<String> frames;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(frames,_outgoing);
+        _num_sending = frames.size();
+    }
+    if (frames.empty()) return;
+    List<shared_ptr<Peer>> peers;
+    {
+        std::lock_guard<std::mutex> lock(_peers_mutex);
+        peers = _peers;
+    }
+    for (auto const& peer : peers) {
+        if (peer->socket_addresses.empty()) peer->socket_addresses = resolve(peer->address);
+        for (auto const& frame : frames) {
+            auto fd = connect_to(peer->socket_addresses);
+            if (fd < 0) {
+                CONCLOG_PRINTLN_AT(1,"island " << peer->address << " is not reachable");
+                break;
+            }
+            if (not write_all(fd,frame.data(),frame.size())) CONCLOG_PRINTLN_AT(1,"could not send to island " << peer->address);
+            close(fd);
+        }
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _num_sending = 0;
+}
+
+void IslandChannel::_accept() {
+    auto fd = accept(_listener.fd,nullptr,nullptr);
+    if (fd < 0) return;
+    set_timeouts(fd);
+    String header(ISLAND_HEADER_SIZE,'\0');
+    if (read_all(fd,header.data(),header.size())) {
+        BinaryReader reader(header);
+        auto magic = reader.read<std::uint32_t>();
+        auto version = reader.read<std::uint32_t>();
+        auto size = reader.read<std::uint64_t>();
+        if (magic == ISLAND_MAGIC and version == ISLAND_VERSION and size <= ISLAND_MAX_PAYLOAD) {
+            String payload(static_cast<size_t>(size),'\0');
+            if (read_all(fd,payload.data(),payload.size())) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _payloads.push_back(payload);
+            }
+        }
+    }
+    close(fd);
+}
+
+IslandExploration::IslandExploration(ExplorationInterface const& exploration, shared_ptr<IslandChannel> const& channel,
+                                     size_t migration_interval, size_t num_migrants)
+    : _exploration(exploration.clone()), _channel(channel), _migration_interval(migration_interval), _num_migrants(num_migrants),
+      _steps(0), _num_immigrants(0) {
+    HELPER_PRECONDITION(channel != nullptr)
+    HELPER_PRECONDITION(migration_interval > 0)
+}
+
+shared_ptr<IslandChannel> const& IslandExploration::channel() const {
+    return _channel;
+}
+
+size_t IslandExploration::num_immigrants() const {
+    return _num_immigrants;
+}
+
+Set<ConfigurationSearchPoint> IslandExploration::next_points_from(List<PointScore> const& scores) {
+    HELPER_PRECONDITION(not scores.empty())
+    ++_steps;
+    if (_num_migrants > 0 and _steps % _migration_interval == 0) {
+        List<PointScore> emigrants;
+        for (auto idx : best_score_indices(scores,std::min(_num_migrants,scores.size()))) emigrants.push_back(scores.at(idx));
+        _channel->send(emigrants);
+    }
+    auto immigrants = _channel->receive(scores.front().point().space());
+    if (immigrants.empty()) return _exploration->next_points_from(scores);
+
+    auto candidates = scores;
+    for (auto const& s : immigrants) candidates.push_back(s);
+    List<PointScore> population;
+    for (auto idx : best_score_indices(candidates,scores.size())) {
+        population.push_back(candidates.at(idx));
+        if (idx >= scores.size()) ++_num_immigrants;
+    }
+    return _exploration->next_points_from(population);
+}
+
+Set<ConfigurationSearchPoint> IslandExploration::contextualise(List<double> const& features, Set<ConfigurationSearchPoint> const& points) {
+    return _exploration->contextualise(features,points);
+}
+
+void IslandExploration::set_seed(std::uint64_t seed) {
+    _exploration->set_seed(derive_seed(seed,1));
+}
+
+void IslandExploration::save_state(BinaryWriter& writer) const {
+    writer.write<std::uint64_t>(_steps);
+    writer.write<std::uint64_t>(_num_immigrants);
+    _exploration->save_state(writer);
+}
+
+void IslandExploration::load_state(BinaryReader& reader, ConfigurationSearchSpace const& space) {
+    _steps = static_cast<size_t>(reader.read<std::uint64_t>());
+    _num_immigrants = static_cast<size_t>(reader.read<std::uint64_t>());
+    _exploration->load_state(reader,space);
+}
+
+ExplorationInterface* IslandExploration::clone() const {
+    return new IslandExploration(*_exploration,_channel,_migration_interval,_num_migrants);
+}
+
+} // namespace pExplore
+
+#endif // PEXPLORE_HAS_ISLANDS
@@ -26,6 +26,9 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <numeric>
+#include "helper/macros.hpp"
 #include "helper/string.hpp"
 #include "score.hpp"
 
@@ -53,6 +56,10 @@ double Score::objective() const {
     return _objective;
 }
 
+Score Score::with_cost(double cost) const {
+    return {_successes,_hard_failures,_soft_failures,_objective+cost};
+}
+
 bool Score::operator<(Score const& e) const {
     if (_hard_failures < e.hard_failures())
         return true;
@@ -93,4 +100,22 @@ ostream& PointScore::_write(ostream& os) const {
     return os << "{" << _point << ": " << _score << "}";
 }
 
+size_t best_score_index(List<PointScore> const& scores) {
+    HELPER_PRECONDITION(not scores.empty())
+    return static_cast<size_t>(std::min_element(scores.begin(),scores.end()) - scores.begin());
+}
+
+List<size_t> best_score_indices(List<PointScore> const& scores, size_t k) {
+    HELPER_PRECONDITION(k <= scores.size())
+    List<size_t> indices;
+    indices.resize(scores.size());
+    std::iota(indices.begin(),indices.end(),0);
+    if (k < indices.size()) {
+        auto nth = indices.begin() + static_cast<std::ptrdiff_t>(k);
+        std::nth_element(indices.begin(),nth,indices.end(),[&scores](size_t a, size_t b) { return scores[a] < scores[b]; });
+        indices.erase(nth,indices.end());
+    }
+    return indices;
+}
+
 } // namespace pExplore
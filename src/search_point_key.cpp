@@ -0,0 +1,173 @@
+/***************************************************************************
+ *            search_point_key.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <limits>
+#include "helper/macros.hpp"
+#include "pronest/configuration_property_path.hpp"
+#include "search_point_key.hpp"
+
+namespace pExplore {
+
+using ProNest::ConfigurationPropertyPath;
+using Helper::Map;
+
+SearchPointKey mix_key(SearchPointKey key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+SearchPointEncoder::SearchPointEncoder(ConfigurationSearchSpace const& space) : _space(space), _exact(true) {
+    SearchPointKey total = 1;
+    for (auto const& p : _space.parameters()) {
+        auto const& values = p.values();
+        HELPER_PRECONDITION(not values.empty())
+        auto minmax = std::minmax_element(values.begin(),values.end());
+        auto radix = static_cast<SearchPointKey>(*minmax.second - *minmax.first) + 1;
+        _offsets.push_back(*minmax.first);
+        _radices.push_back(radix);
+        if (total > std::numeric_limits<SearchPointKey>::max()/radix) _exact = false;
+        else total *= radix;
+    }
+}
+
+ConfigurationSearchSpace const& SearchPointEncoder::space() const {
+    return _space;
+}
+
+bool SearchPointEncoder::is_exact() const {
+    return _exact;
+}
+
+SearchPointKey SearchPointEncoder::encode(ConfigurationSearchPoint const& point) const {
+    return encode(point.coordinates());
+}
+
+SearchPointKey SearchPointEncoder::encode(List<int> const& coordinates) const {
+    HELPER_PRECONDITION(coordinates.size() == _radices.size())
+    SearchPointKey result = 0;
+    if (_exact) {
+        for (size_t i=coordinates.size(); i>0; --i)
+            result = result*_radices[i-1] + static_cast<SearchPointKey>(coordinates[i-1]-_offsets[i-1]);
+    } else {
+        for (auto c : coordinates)
+            result = mix_key(result ^ static_cast<SearchPointKey>(static_cast<std::uint32_t>(c)));
+    }
+    return result;
+}
+
+ConfigurationSearchPoint SearchPointEncoder::decode(SearchPointKey key) const {
+    HELPER_PRECONDITION(_exact)
+    List<int> coordinates;
+    coordinates.reserve(_radices.size());
+    for (size_t i=0; i<_radices.size(); ++i) {
+        coordinates.push_back(_offsets[i] + static_cast<int>(key % _radices[i]));
+        key /= _radices[i];
+    }
+    return make_point_from_coordinates(_space,coordinates);
+}
+
+ConfigurationSearchPoint make_point_from_coordinates(ConfigurationSearchSpace const& space, List<int> const& coordinates) {
+    auto const& parameters = space.parameters();
+    HELPER_PRECONDITION(coordinates.size() == parameters.size())
+    Map<ConfigurationPropertyPath,int> bindings;
+    for (size_t i=0; i<parameters.size(); ++i)
+        bindings.insert(parameters[i].path(),coordinates[i]);
+    return space.make_point(bindings);
+}
+
+SearchPointKeySet::SearchPointKeySet(size_t expected_size) : _size(0) {
+    size_t capacity = 16;
+    while (capacity < 2*expected_size) capacity *= 2;
+    _keys.resize(capacity);
+    _occupied.resize(capacity,0);
+}
+
+size_t SearchPointKeySet::_slot_for(SearchPointKey key) const {
+    size_t mask = _keys.size()-1;
+    size_t slot = static_cast<size_t>(mix_key(key)) & mask;
+    while (_occupied[slot] and _keys[slot] != key) slot = (slot+1) & mask;
+    return slot;
+}
+
+void SearchPointKeySet::_grow() {
+    List<SearchPointKey> keys;
+    List<unsigned char> occupied;
+    keys.resize(2*_keys.size());
+    occupied.resize(2*_keys.size(),0);
+    std::swap(keys,_keys);
+    std::swap(occupied,_occupied);
+    for (size_t i=0; i<keys.size(); ++i) {
+        if (occupied[i]) {
+            auto slot = _slot_for(keys[i]);
+            _keys[slot] = keys[i];
+            _occupied[slot] = 1;
+        }
+    }
+}
+
+bool SearchPointKeySet::insert(SearchPointKey key) {
+    if (2*(_size+1) > _keys.size()) _grow();
+    auto slot = _slot_for(key);
+    if (_occupied[slot]) return false;
+    _keys[slot] = key;
+    _occupied[slot] = 1;
+    ++_size;
+    return true;
+}
+
+bool SearchPointKeySet::contains(SearchPointKey key) const {
+    return _occupied[_slot_for(key)];
+}
+
+size_t SearchPointKeySet::size() const {
+    return _size;
+}
+
+bool SearchPointKeySet::empty() const {
+    return _size == 0;
+}
+
+void SearchPointKeySet::clear() {
+    std::fill(_occupied.begin(),_occupied.end(),0);
+    _size = 0;
+}
+
+List<SearchPointKey> SearchPointKeySet::keys() const {
+    List<SearchPointKey> result;
+    result.reserve(_size);
+    for (size_t i=0; i<_keys.size(); ++i)
+        if (_occupied[i]) result.push_back(_keys[i]);
+    return result;
+}
+
+} // namespace pExplore
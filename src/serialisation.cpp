@@ -0,0 +1,175 @@
+/***************************************************************************
+ *            serialisation.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include "search_point_key.hpp"
+#include "serialisation.hpp"
+
+namespace pExplore {
+
+void BinaryWriter::write(String const& value) {
+    write<std::uint64_t>(value.size());
+    _data.append(value);
+}
+
+void BinaryWriter::write(List<int> const& values) {
+    write<std::uint64_t>(values.size());
+    for (auto v : values) write<std::int32_t>(v);
+}
+
+void BinaryWriter::write(List<double> const& values) {
+    write<std::uint64_t>(values.size());
+    for (auto v : values) write<double>(v);
+}
+
+void BinaryWriter::write(List<size_t> const& values) {
+    write<std::uint64_t>(values.size());
+    for (auto v : values) write<std::uint64_t>(v);
+}
+
+String const& BinaryWriter::data() const {
+    return _data;
+}
+
+BinaryReader::BinaryReader(String const& data) : _data(data), _position(0) { }
+
+void BinaryReader::_require(size_t num_bytes) const {
+    // Compared with the remaining bytes, since a size read from the data may be arbitrarily large
+    if (num_bytes > _data.size() - _position)
+        throw DeserialisationException("Binary data exhausted: " + std::to_string(num_bytes) + " bytes required at position " + std::to_string(_position) + " of " + std::to_string(_data.size()));
+}
+
+void BinaryReader::_require(size_t num_items, size_t item_size) const {
+    if (num_items > (_data.size() - _position) / item_size)
+        throw DeserialisationException("Binary data exhausted: " + std::to_string(num_items) + " items of " + std::to_string(item_size) + " bytes required at position " + std::to_string(_position) + " of " + std::to_string(_data.size()));
+}
+
+String BinaryReader::read_string() {
+    auto size = static_cast<size_t>(read<std::uint64_t>());
+    _require(size);
+    String result = _data.substr(_position,size);
+    _position += size;
+    return result;
+}
+
+List<int> BinaryReader::read_ints() {
+    auto size = static_cast<size_t>(read<std::uint64_t>());
+    _require(size,sizeof(std::int32_t));
+    List<int> result;
+    result.reserve(size);
+    for (size_t i=0; i<size; ++i) result.push_back(read<std::int32_t>());
+    return result;
+}
+
+List<double> BinaryReader::read_doubles() {
+    auto size = static_cast<size_t>(read<std::uint64_t>());
+    _require(size,sizeof(double));
+    List<double> result;
+    result.reserve(size);
+    for (size_t i=0; i<size; ++i) result.push_back(read<double>());
+    return result;
+}
+
+List<size_t> BinaryReader::read_sizes() {
+    auto size = static_cast<size_t>(read<std::uint64_t>());
+    _require(size,sizeof(std::uint64_t));
+    List<size_t> result;
+    result.reserve(size);
+    for (size_t i=0; i<size; ++i) result.push_back(static_cast<size_t>(read<std::uint64_t>()));
+    return result;
+}
+
+bool BinaryReader::at_end() const {
+    return _position == _data.size();
+}
+
+void write_point(BinaryWriter& writer, ConfigurationSearchPoint const& point) {
+    writer.write(point.coordinates());
+}
+
+ConfigurationSearchPoint read_point(BinaryReader& reader, ConfigurationSearchSpace const& space) {
+    auto coordinates = reader.read_ints();
+    if (coordinates.size() != space.dimension())
+        throw DeserialisationException("Point dimension " + std::to_string(coordinates.size()) + " does not match the space dimension " + std::to_string(space.dimension()));
+    auto const& parameters = space.parameters();
+    for (size_t i=0; i<coordinates.size(); ++i) {
+        auto const& values = parameters[i].values();
+        if (std::find(values.begin(),values.end(),coordinates[i]) == values.end())
+            throw DeserialisationException("Coordinate " + std::to_string(coordinates[i]) + " is not a value of parameter " + std::to_string(i));
+    }
+    return make_point_from_coordinates(space,coordinates);
+}
+
+namespace {
+
+List<size_t> to_list(Set<size_t> const& indices) {
+    List<size_t> result;
+    for (auto i : indices) result.push_back(i);
+    return result;
+}
+
+Set<size_t> to_set(List<size_t> const& indices) {
+    Set<size_t> result;
+    for (auto i : indices) result.insert(i);
+    return result;
+}
+
+}
+
+void write_point_score(BinaryWriter& writer, PointScore const& point_score) {
+    write_point(writer,point_score.point());
+    auto const& score = point_score.score();
+    writer.write(to_list(score.successes()));
+    writer.write(to_list(score.hard_failures()));
+    writer.write(to_list(score.soft_failures()));
+    writer.write(score.objective());
+}
+
+PointScore read_point_score(BinaryReader& reader, ConfigurationSearchSpace const& space) {
+    auto point = read_point(reader,space);
+    auto successes = to_set(reader.read_sizes());
+    auto hard_failures = to_set(reader.read_sizes());
+    auto soft_failures = to_set(reader.read_sizes());
+    auto objective = reader.read<double>();
+    return {point,{successes,hard_failures,soft_failures,objective}};
+}
+
+void write_generator(BinaryWriter& writer, RandomGenerator const& generator) {
+    std::ostringstream ss;
+    ss << generator;
+    writer.write(ss.str());
+}
+
+void read_generator(BinaryReader& reader, RandomGenerator& generator) {
+    std::istringstream ss(reader.read_string());
+    ss >> generator;
+    if (ss.fail()) throw DeserialisationException("Invalid random generator state");
+}
+
+} // namespace pExplore
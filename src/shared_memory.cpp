@@ -0,0 +1,245 @@
+/***************************************************************************
+ *            shared_memory.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "shared_memory.hpp"
+
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <semaphore.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "helper/macros.hpp"
+
+namespace pExplore {
+
+namespace {
+
+std::system_error system_error(char const* what) {
+    return std::system_error(errno,std::generic_category(),what);
+}
+
+//! \brief Wait on \a semaphore, for at most \a timeout_ms milliseconds unless negative, retrying on interruption
+bool wait_on(sem_t* semaphore, long timeout_ms) {
+    if (timeout_ms < 0) {
+        while (sem_wait(semaphore) != 0)
+            if (errno != EINTR) throw system_error("sem_wait");
+        return true;
+    }
+    if (timeout_ms == 0) {
+        while (sem_trywait(semaphore) != 0) {
+            if (errno == EAGAIN) return false;
+            if (errno != EINTR) throw system_error("sem_trywait");
+        }
+        return true;
+    }
+    timespec deadline;
+    clock_gettime(CLOCK_REALTIME,&deadline);
+    deadline.tv_sec += timeout_ms/1000;
+    deadline.tv_nsec += (timeout_ms%1000)*1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000;
+    }
+    while (sem_timedwait(semaphore,&deadline) != 0) {
+        if (errno == ETIMEDOUT) return false;
+        if (errno != EINTR) throw system_error("sem_timedwait");
+    }
+    return true;
+}
+
+//! \brief The alignment of the slots and of their data
+const size_t SLOT_ALIGNMENT = alignof(std::max_align_t);
+//! \brief The size of the header of each slot, holding the size of its data
+const size_t SLOT_HEADER_SIZE = SLOT_ALIGNMENT;
+
+size_t aligned(size_t size) {
+    return (size + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+}
+
+}
+
+SharedMemoryRegion::SharedMemoryRegion(size_t size) : _data(nullptr), _size(size) {
+    HELPER_PRECONDITION(size > 0)
+    void* data = mmap(nullptr,size,PROT_READ | PROT_WRITE,MAP_SHARED | MAP_ANONYMOUS,-1,0);
+    if (data == MAP_FAILED) throw system_error("mmap");
+    _data = static_cast<unsigned char*>(data);
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    munmap(_data,_size);
+}
+
+unsigned char* SharedMemoryRegion::data() const {
+    return _data;
+}
+
+size_t SharedMemoryRegion::size() const {
+    return _size;
+}
+
+struct SharedRingBuffer::Header {
+    sem_t items;
+    sem_t spaces;
+    // Each index is written by one side only, and read by the same side
+    std::uint64_t head;
+    std::uint64_t tail;
+};
+
+SharedRingBuffer::SharedRingBuffer(size_t num_slots, size_t slot_capacity)
+    : _num_slots(num_slots), _slot_capacity(slot_capacity),
+      _region(aligned(sizeof(Header)) + num_slots*aligned(SLOT_HEADER_SIZE+slot_capacity)) {
+    HELPER_PRECONDITION(num_slots > 0)
+    HELPER_PRECONDITION(slot_capacity > 0)
+    auto& header = *new (_region.data()) Header;
+    if (sem_init(&header.items,1,0) != 0) throw system_error("sem_init");
+    if (sem_init(&header.spaces,1,static_cast<unsigned int>(num_slots)) != 0) throw system_error("sem_init");
+    header.head = 0;
+    header.tail = 0;
+}
+
+SharedRingBuffer::~SharedRingBuffer() {
+    sem_destroy(&_header().items);
+    sem_destroy(&_header().spaces);
+}
+
+auto SharedRingBuffer::_header() const -> Header& {
+    return *reinterpret_cast<Header*>(_region.data());
+}
+
+unsigned char* SharedRingBuffer::_slot(std::uint64_t index) const {
+    return _region.data() + aligned(sizeof(Header)) + static_cast<size_t>(index % _num_slots)*aligned(SLOT_HEADER_SIZE+_slot_capacity);
+}
+
+size_t SharedRingBuffer::num_slots() const {
+    return _num_slots;
+}
+
+size_t SharedRingBuffer::slot_capacity() const {
+    return _slot_capacity;
+}
+
+unsigned char* SharedRingBuffer::begin_push() {
+    auto& header = _header();
+    wait_on(&header.spaces,-1);
+    return _slot(header.tail) + SLOT_HEADER_SIZE;
+}
+
+void SharedRingBuffer::end_push(size_t size) {
+    HELPER_PRECONDITION(size <= _slot_capacity)
+    auto& header = _header();
+    std::uint64_t slot_size = size;
+    std::memcpy(_slot(header.tail),&slot_size,sizeof(slot_size));
+    ++header.tail;
+    sem_post(&header.items);
+}
+
+unsigned char const* SharedRingBuffer::begin_pull(size_t& size, long timeout_ms) {
+    auto& header = _header();
+    if (not wait_on(&header.items,timeout_ms)) return nullptr;
+    auto slot = _slot(header.head);
+    std::uint64_t slot_size;
+    std::memcpy(&slot_size,slot,sizeof(slot_size));
+    size = static_cast<size_t>(slot_size);
+    return slot + SLOT_HEADER_SIZE;
+}
+
+void SharedRingBuffer::end_pull() {
+    auto& header = _header();
+    ++header.head;
+    sem_post(&header.spaces);
+}
+
+void SharedRingBuffer::reset() {
+    auto& header = _header();
+    sem_destroy(&header.items);
+    sem_destroy(&header.spaces);
+    if (sem_init(&header.items,1,0) != 0) throw system_error("sem_init");
+    if (sem_init(&header.spaces,1,static_cast<unsigned int>(_num_slots)) != 0) throw system_error("sem_init");
+    header.head = 0;
+    header.tail = 0;
+}
+
+pid_t fork_process(std::function<int()> const& body) {
+    auto pid = fork();
+    if (pid < 0) throw system_error("fork");
+    if (pid == 0) {
+        int result = 1;
+        try {
+            result = body();
+        } catch (...) { }
+        _exit(result);
+    }
+    return pid;
+}
+
+bool has_terminated(pid_t pid) {
+    int status;
+    auto result = waitpid(pid,&status,WNOHANG);
+    return result == pid or (result < 0 and errno == ECHILD);
+}
+
+void wait_process(pid_t pid) {
+    int status;
+    while (waitpid(pid,&status,0) < 0)
+        if (errno != EINTR) return;
+}
+
+bool wait_process(pid_t pid, long timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    // Short tasks are noticed quickly, while long ones are polled with a bounded overhead
+    auto interval = std::chrono::microseconds(50);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (has_terminated(pid)) return true;
+        std::this_thread::sleep_for(interval);
+        interval = std::min<std::chrono::microseconds>(interval*2,std::chrono::milliseconds(10));
+    }
+    if (has_terminated(pid)) return true;
+    kill(pid,SIGKILL);
+    wait_process(pid);
+    return false;
+}
+
+void terminate_process(pid_t pid, long timeout_ms) {
+    wait_process(pid,timeout_ms);
+}
+
+} // namespace pExplore
+
+#endif // PEXPLORE_HAS_PROCESS_ISOLATION
@@ -0,0 +1,117 @@
+/***************************************************************************
+ *            shifting.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include "helper/macros.hpp"
+#include "pronest/configuration_search_space.hpp"
+#include "search_point_key.hpp"
+#include "shifting.hpp"
+
+namespace pExplore {
+
+using Helper::List;
+
+namespace {
+//! \brief How many consecutive duplicate shifts are tolerated before increasing the shift distance
+const size_t DUPLICATES_BEFORE_WIDENING = 16;
+}
+
+std::uint64_t make_random_seed() {
+    std::random_device device;
+    return (static_cast<std::uint64_t>(device()) << 32) ^ static_cast<std::uint64_t>(device());
+}
+
+std::uint64_t derive_seed(std::uint64_t seed, std::uint64_t stream) {
+    return mix_key(mix_key(seed) + stream);
+}
+
+ConfigurationSearchPoint make_shifted(ConfigurationSearchPoint const& point, size_t distance, RandomGenerator& generator) {
+    auto const& space = point.space();
+    auto const& parameters = space.parameters();
+    List<size_t> shiftable;
+    for (size_t i=0; i<parameters.size(); ++i)
+        if (parameters[i].values().size() > 1) shiftable.push_back(i);
+    if (shiftable.empty()) return point;
+
+    auto coordinates = point.coordinates();
+    std::uniform_int_distribution<size_t> parameter_distribution(0,shiftable.size()-1);
+    for (size_t s=0; s<distance; ++s) {
+        auto i = shiftable[parameter_distribution(generator)];
+        auto values = parameters[i].values();
+        std::sort(values.begin(),values.end());
+        auto position = static_cast<size_t>(std::lower_bound(values.begin(),values.end(),coordinates[i])-values.begin());
+        HELPER_ASSERT(position < values.size())
+        if (parameters[i].is_metric()) {
+            bool upward;
+            if (position == 0) upward = true;
+            else if (position+1 == values.size()) upward = false;
+            else upward = std::bernoulli_distribution(0.5)(generator);
+            position = (upward ? position+1 : position-1);
+        } else {
+            // Draw among the other values, skipping the current one
+            auto other = std::uniform_int_distribution<size_t>(0,values.size()-2)(generator);
+            position = (other >= position ? other+1 : other);
+        }
+        coordinates[i] = values[position];
+    }
+    return make_point_from_coordinates(space,coordinates);
+}
+
+Set<ConfigurationSearchPoint> make_extended_set_by_shifting(Set<ConfigurationSearchPoint> const& sources, size_t size, RandomGenerator& generator) {
+    HELPER_PRECONDITION(not sources.empty())
+    auto const& space = sources.begin()->space();
+    HELPER_PRECONDITION(size <= space.total_points())
+
+    // Any point is reachable within this distance, so there is no need to go further
+    size_t maximum_distance = 1;
+    for (auto const& p : space.parameters()) maximum_distance += p.values().size()-1;
+
+    Set<ConfigurationSearchPoint> result = sources;
+    List<ConfigurationSearchPoint> pool;
+    for (auto const& p : sources) pool.push_back(p);
+    size_t distance = 1;
+    size_t duplicates = 0;
+    while (result.size() < size) {
+        auto const& source = pool[std::uniform_int_distribution<size_t>(0,pool.size()-1)(generator)];
+        auto shifted = make_shifted(source,distance,generator);
+        if (result.contains(shifted)) {
+            if (++duplicates >= DUPLICATES_BEFORE_WIDENING) {
+                distance = std::min(distance+1,maximum_distance);
+                duplicates = 0;
+            }
+            continue;
+        }
+        result.insert(shifted);
+        pool.push_back(shifted);
+        duplicates = 0;
+    }
+    return result;
+}
+
+} // namespace pExplore
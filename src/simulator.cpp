@@ -0,0 +1,100 @@
+/***************************************************************************
+ *            simulator.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include "helper/macros.hpp"
+#include "pronest/configuration_search_space.hpp"
+#include "simulator.hpp"
+
+namespace pExplore {
+
+ostream& SimulationReport::_write(ostream& os) const {
+    return os << "{best=" << best << ", time_to_best=" << time_to_best << ", steps_to_best=" << steps_to_best
+              << ", total_time=" << total_time << ", utilisation=" << utilisation << "}";
+}
+
+ExplorationSimulator::ExplorationSimulator(ExecutionTrace const& trace, ExplorationInterface const& exploration,
+                                           InitialisationInterface const& initialisation, size_t num_cores)
+    : _trace(trace), _exploration(exploration.clone()), _initialisation(initialisation.clone()), _num_cores(num_cores), _seed(make_random_seed()) {
+    HELPER_PRECONDITION(not trace.empty())
+    HELPER_PRECONDITION(num_cores > 0)
+}
+
+void ExplorationSimulator::set_seed(std::uint64_t seed) {
+    _seed = seed;
+}
+
+SimulationReport ExplorationSimulator::run(ConfigurationSearchPoint const& initial_point, size_t concurrency, size_t num_steps) const {
+    HELPER_PRECONDITION(concurrency > 0 and concurrency <= initial_point.space().total_points())
+    HELPER_PRECONDITION(num_steps > 0)
+    shared_ptr<ExplorationInterface> exploration(_exploration->clone());
+    shared_ptr<InitialisationInterface> initialisation(_initialisation->clone());
+    exploration->set_seed(derive_seed(_seed,1));
+    initialisation->set_seed(derive_seed(_seed,2));
+
+    auto points = initialisation->initial_points(initial_point,concurrency);
+    double clock = 0.0;
+    double busy_time = 0.0;
+    List<double> core_available;
+    core_available.resize(_num_cores,0.0);
+    List<double> step_end_times;
+    List<PointScore> step_best_scores;
+    shared_ptr<PointScore> best;
+    double time_to_best = 0.0;
+    size_t steps_to_best = 0;
+
+    for (size_t step=0; step<num_steps; ++step) {
+        List<PointScore> scores;
+        std::fill(core_available.begin(),core_available.end(),clock);
+        for (auto const& p : points) {
+            auto const& entry = _trace.lookup(p.coordinates(),step);
+            auto core = std::min_element(core_available.begin(),core_available.end());
+            *core += entry.latency;
+            busy_time += entry.latency;
+            scores.push_back(PointScore(p,entry.score));
+        }
+        clock = *std::max_element(core_available.begin(),core_available.end());
+        step_end_times.push_back(clock);
+
+        auto const& step_best = scores.at(best_score_index(scores));
+        step_best_scores.push_back(step_best);
+        if (best == nullptr or step_best < *best) {
+            best.reset(new PointScore(step_best));
+            time_to_best = clock;
+            steps_to_best = step+1;
+        }
+
+        if (step+1 < num_steps) points = exploration->next_points_from(scores);
+    }
+
+    auto utilisation = (clock > 0 ? busy_time/(clock*static_cast<double>(_num_cores)) : 0.0);
+    return {*best,time_to_best,steps_to_best,clock,utilisation,step_end_times,step_best_scores};
+}
+
+} // namespace pExplore
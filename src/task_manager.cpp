@@ -35,24 +35,172 @@ namespace pExplore {
 
 using std::make_pair;
 
-TaskManager::TaskManager() : _exploration(new ShiftAndKeepBestHalfExploration()) {}
+namespace {
+//! \brief The stream of the seed for initial points, apart from the streams of the runners, explorations and initialisations
+const std::uint64_t INITIAL_POINT_STREAM = 3;
+}
+
+TaskManager::TaskManager() : _exploration(new ShiftAndKeepBestHalfExploration()), _initialisation(new RandomShiftInitialisation()),
+                             _decision_log_mode(DecisionLog::Mode::RECORD), _isolation(RunnerIsolation::THREAD), _process_slot_capacity(1 << 20),
+                             _process_task_timeout(std::chrono::minutes(10)),
+                             _affinity(AffinityPolicy::none()), _runtime_weight(0.0), _settings_version(0) {}
+
+void TaskManager::set_concurrency_override(size_t concurrency) {
+    HELPER_PRECONDITION(concurrency > 0)
+    _concurrency_override = concurrency;
+}
+
+void TaskManager::clear_concurrency_override() {
+    _concurrency_override.reset();
+}
+
+size_t TaskManager::search_concurrency() const {
+    if (_concurrency_override.has_value()) return _concurrency_override.value();
+    auto requested = BetterThreads::ThreadManager::instance().concurrency();
+    auto available = available_concurrency();
+    if (requested > available) {
+        CONCLOG_PRINTLN_AT(1,"Concurrency limited to the " << available << " processors available instead of " << requested);
+        return available;
+    }
+    return requested;
+}
 
 void TaskManager::set_exploration(ExplorationInterface const& exploration) {
     _exploration.reset(exploration.clone());
+    ++_settings_version;
+}
+
+void TaskManager::set_initialisation(InitialisationInterface const& initialisation) {
+    _initialisation.reset(initialisation.clone());
+    ++_settings_version;
+}
+
+void TaskManager::set_fidelity_schedule(SuccessiveHalvingSchedule const& schedule) {
+    _fidelity_schedule = schedule;
+    ++_settings_version;
+}
+
+void TaskManager::set_checkpoint_file(String const& filename) {
+    _checkpoint_file = filename;
+    ++_settings_version;
+}
+
+String const& TaskManager::checkpoint_file() const {
+    return _checkpoint_file;
+}
+
+void TaskManager::set_seed(std::uint64_t seed) {
+    _seed = seed;
+    ++_settings_version;
+}
+
+void TaskManager::clear_seed() {
+    _seed.reset();
+    ++_settings_version;
+}
+
+ConfigurationSearchPoint TaskManager::initial_point(ConfigurationSearchSpace const& space) const {
+    if (not _seed.has_value()) return space.initial_point();
+    RandomGenerator generator(derive_seed(_seed.value(),INITIAL_POINT_STREAM));
+    List<int> coordinates;
+    for (auto const& p : space.parameters()) {
+        auto const& values = p.values();
+        coordinates.push_back(values[std::uniform_int_distribution<size_t>(0,values.size()-1)(generator)]);
+    }
+    return make_point_from_coordinates(space,coordinates);
+}
+
+void TaskManager::set_decision_log(String const& filename, DecisionLog::Mode mode) {
+    HELPER_PRECONDITION(not filename.empty())
+    _decision_log_file = filename;
+    _decision_log_mode = mode;
+    ++_settings_version;
+}
+
+void TaskManager::clear_decision_log() {
+    _decision_log_file.clear();
+    ++_settings_version;
 }
 
-List<Set<PointScore>> const& TaskManager::scores() const {
+void TaskManager::set_trace_file(String const& filename) {
+    _trace_file = filename;
+    ++_settings_version;
+}
+
+void TaskManager::set_isolation(RunnerIsolation isolation) {
+    _isolation = isolation;
+    ++_settings_version;
+}
+
+void TaskManager::set_process_slot_capacity(size_t capacity) {
+    HELPER_PRECONDITION(capacity > 0)
+    _process_slot_capacity = capacity;
+    ++_settings_version;
+}
+
+void TaskManager::set_process_task_timeout(std::chrono::milliseconds timeout) {
+    HELPER_PRECONDITION(timeout.count() > 0)
+    _process_task_timeout = timeout;
+    ++_settings_version;
+}
+
+void TaskManager::set_affinity(AffinityPolicy const& policy) {
+    _affinity = policy;
+    ++_settings_version;
+}
+
+AffinityPolicy const& TaskManager::affinity() const {
+    return _affinity;
+}
+
+void TaskManager::set_step_budget(std::chrono::microseconds budget) {
+    HELPER_PRECONDITION(budget.count() > 0)
+    _step_budget = budget;
+    ++_settings_version;
+}
+
+void TaskManager::clear_step_budget() {
+    _step_budget.reset();
+    ++_settings_version;
+}
+
+void TaskManager::set_runtime_weight(double weight) {
+    HELPER_PRECONDITION(weight >= 0.0)
+    _runtime_weight = weight;
+    ++_settings_version;
+}
+
+double TaskManager::runtime_weight() const {
+    return _runtime_weight;
+}
+
+ParameterSearchSettings TaskManager::_search_settings(size_t concurrency) const {
+    List<ProcessorLocation> topology;
+    if (_affinity.kind() != AffinityPolicy::Kind::NONE) {
+        topology = read_processor_topology();
+        if (_affinity.assign(topology,concurrency).empty()) CONCLOG_PRINTLN_AT(1,"Processor topology not available: threads are not pinned.");
+    }
+    return {_exploration,_initialisation,_fidelity_schedule,_checkpoint_file,(_seed.has_value() ? _seed.value() : make_random_seed()),
+            _make_decision_log(),(_trace_file.empty() ? nullptr : std::make_shared<TraceRecorder>(_trace_file)),_affinity,topology,_settings_version,_runtime_weight};
+}
+
+std::shared_ptr<DecisionLog> TaskManager::_make_decision_log() const {
+    if (_decision_log_file.empty()) return nullptr;
+    return std::make_shared<DecisionLog>(_decision_log_file,_decision_log_mode);
+}
+
+List<List<PointScore>> const& TaskManager::scores() const {
     return _scores;
 }
 
 List<PointScore> TaskManager::best_scores() const {
     List<PointScore> result;
     for (auto const& e : _scores)
-        result.append(*e.begin());
+        result.append(e.at(best_score_index(e)));
     return result;
 }
 
-void TaskManager::append_scores(Set<PointScore> const& scores) {
+void TaskManager::append_scores(List<PointScore> const& scores) {
     std::lock_guard<std::mutex> lock(_data_mutex);
     _scores.push_back(scores);
 }
@@ -84,6 +232,10 @@ List<int> TaskManager::optimal_point() const {
     return result;
 }
 
+void TaskManager::save_warm_start(WarmStartStore const& store, String const& tag) const {
+    store.save(tag,best_scores());
+}
+
 void TaskManager::print_best_scores() const {
     auto best = best_scores();
     if (not best.empty()) {
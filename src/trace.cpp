@@ -0,0 +1,186 @@
+/***************************************************************************
+ *            trace.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include "helper/macros.hpp"
+#include "trace.hpp"
+
+namespace pExplore {
+
+namespace {
+const String TRACE_HEADER = "pexplore-trace 1";
+
+template<class C> void write_values(std::ostream& os, C const& values) {
+    if (values.empty()) {
+        os << "-";
+        return;
+    }
+    bool first = true;
+    for (auto v : values) {
+        os << (first ? "" : ",") << v;
+        first = false;
+    }
+}
+
+long long value_from(String const& value, long long minimum, long long maximum, String const& filename) {
+    try {
+        size_t parsed = 0;
+        auto result = std::stoll(value,&parsed);
+        if (parsed == value.size() and result >= minimum and result <= maximum) return result;
+    } catch (std::logic_error&) { }
+    throw std::runtime_error("Invalid value '" + value + "' in trace '" + filename + "'");
+}
+
+List<long long> read_values(String const& token, long long minimum, long long maximum, String const& filename) {
+    List<long long> result;
+    if (token == "-") return result;
+    std::istringstream ss(token);
+    String value;
+    while (std::getline(ss,value,',')) result.push_back(value_from(value,minimum,maximum,filename));
+    return result;
+}
+
+Set<size_t> to_indices(List<long long> const& values) {
+    Set<size_t> result;
+    for (auto v : values) result.insert(static_cast<size_t>(v));
+    return result;
+}
+
+void write_entry(std::ostream& os, TraceEntry const& e) {
+    os << e.step << " " << e.latency << " " << e.score.objective() << " ";
+    write_values(os,e.score.successes());
+    os << " ";
+    write_values(os,e.score.hard_failures());
+    os << " ";
+    write_values(os,e.score.soft_failures());
+    os << " ";
+    write_values(os,e.coordinates);
+    os << "\n";
+}
+}
+
+ostream& TraceEntry::_write(ostream& os) const {
+    return os << "{" << coordinates << ": step=" << step << ", latency=" << latency << ", score=" << score << "}";
+}
+
+ExecutionTrace ExecutionTrace::load(String const& filename) {
+    std::ifstream file(filename);
+    if (not file.is_open()) throw std::runtime_error("Could not open trace '" + filename + "'");
+    String line;
+    std::getline(file,line);
+    if (line != TRACE_HEADER) throw std::runtime_error("File '" + filename + "' is not an execution trace");
+    ExecutionTrace result;
+    while (std::getline(file,line)) {
+        std::istringstream ls(line);
+        size_t step;
+        double latency, objective;
+        String successes, hard_failures, soft_failures, coordinates;
+        if (not (ls >> step >> latency >> objective >> successes >> hard_failures >> soft_failures >> coordinates))
+            throw std::runtime_error("Invalid trace line '" + line + "' in '" + filename + "'");
+        auto read_indices = [&filename](String const& token) {
+            return to_indices(read_values(token,0,std::numeric_limits<long long>::max(),filename)); };
+        List<int> point;
+        for (auto c : read_values(coordinates,std::numeric_limits<int>::min(),std::numeric_limits<int>::max(),filename))
+            point.push_back(static_cast<int>(c));
+        result.add(TraceEntry(point,step,latency,Score(read_indices(successes),read_indices(hard_failures),read_indices(soft_failures),objective)));
+    }
+    return result;
+}
+
+void ExecutionTrace::save(String const& filename) const {
+    std::ofstream file(filename, std::ios::trunc);
+    if (not file.is_open()) throw std::runtime_error("Could not open trace '" + filename + "' for writing");
+    file << TRACE_HEADER << "\n" << std::setprecision(17);
+    for (auto const& e : _entries) write_entry(file,e);
+}
+
+void ExecutionTrace::add(TraceEntry const& entry) {
+    _indices[entry.coordinates].push_back(_entries.size());
+    _entries.push_back(entry);
+}
+
+List<TraceEntry> const& ExecutionTrace::entries() const {
+    return _entries;
+}
+
+size_t ExecutionTrace::size() const {
+    return _entries.size();
+}
+
+bool ExecutionTrace::empty() const {
+    return _entries.empty();
+}
+
+TraceEntry const& ExecutionTrace::lookup(List<int> const& coordinates, size_t step) const {
+    HELPER_PRECONDITION(not empty())
+    auto it = _indices.find(coordinates);
+    if (it == _indices.end()) {
+        double nearest_distance = std::numeric_limits<double>::infinity();
+        for (auto candidate = _indices.begin(); candidate != _indices.end(); ++candidate) {
+            auto const& c = candidate->first;
+            if (c.size() != coordinates.size()) continue;
+            double distance2 = 0.0;
+            for (size_t i=0; i<c.size(); ++i) {
+                auto d = static_cast<double>(c[i]-coordinates[i]);
+                distance2 += d*d;
+            }
+            if (distance2 < nearest_distance) {
+                nearest_distance = distance2;
+                it = candidate;
+            }
+        }
+        if (it == _indices.end()) throw std::runtime_error("No recorded coordinates with dimension " + std::to_string(coordinates.size()));
+    }
+    auto step_distance = [step](size_t s) { return (s > step ? s-step : step-s); };
+    size_t best = it->second.front();
+    for (auto idx : it->second)
+        if (step_distance(_entries[idx].step) < step_distance(_entries[best].step)) best = idx;
+    return _entries[best];
+}
+
+TraceRecorder::TraceRecorder(String const& filename) : _filename(filename), _file(filename, std::ios::trunc) {
+    if (not _file.is_open()) throw std::runtime_error("Could not open trace '" + filename + "' for writing");
+    _file << TRACE_HEADER << "\n" << std::setprecision(17);
+    _file.flush();
+}
+
+String const& TraceRecorder::filename() const {
+    return _filename;
+}
+
+void TraceRecorder::record(TraceEntry const& entry) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    write_entry(_file,entry);
+    _file.flush();
+}
+
+} // namespace pExplore
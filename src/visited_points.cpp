@@ -0,0 +1,122 @@
+/***************************************************************************
+ *            visited_points.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include "helper/macros.hpp"
+#include "visited_points.hpp"
+
+namespace pExplore {
+
+namespace {
+const size_t FILTER_HASHES = 4;
+}
+
+VisitedPoints::VisitedPoints(ConfigurationSearchSpace const& space, size_t exact_capacity, size_t filter_bits)
+    : _encoder(space), _exact(_encoder.is_exact() and space.total_points() <= exact_capacity), _size(0) {
+    if (not _exact) {
+        size_t words = 1;
+        while (64*words < filter_bits) words *= 2;
+        _filter_words.resize(words,0);
+    }
+}
+
+bool VisitedPoints::is_exact() const {
+    return _exact;
+}
+
+bool VisitedPoints::_filter_contains(SearchPointKey key) const {
+    auto mask = 64*_filter_words.size()-1;
+    auto h1 = mix_key(key);
+    auto h2 = mix_key(h1) | 1;
+    for (size_t i=0; i<FILTER_HASHES; ++i) {
+        auto bit = static_cast<size_t>(h1 + i*h2) & mask;
+        if ((_filter_words[bit/64] & (std::uint64_t(1) << (bit%64))) == 0) return false;
+    }
+    return true;
+}
+
+void VisitedPoints::insert(ConfigurationSearchPoint const& point) {
+    auto key = _encoder.encode(point);
+    if (_exact) {
+        if (_keys.insert(key)) ++_size;
+    } else if (not _filter_contains(key)) {
+        auto mask = 64*_filter_words.size()-1;
+        auto h1 = mix_key(key);
+        auto h2 = mix_key(h1) | 1;
+        for (size_t i=0; i<FILTER_HASHES; ++i) {
+            auto bit = static_cast<size_t>(h1 + i*h2) & mask;
+            _filter_words[bit/64] |= std::uint64_t(1) << (bit%64);
+        }
+        ++_size;
+    }
+}
+
+bool VisitedPoints::contains(ConfigurationSearchPoint const& point) const {
+    auto key = _encoder.encode(point);
+    if (_exact) return _keys.contains(key);
+    else return _filter_contains(key);
+}
+
+size_t VisitedPoints::size() const {
+    return _size;
+}
+
+void VisitedPoints::clear() {
+    _keys.clear();
+    std::fill(_filter_words.begin(),_filter_words.end(),0);
+    _size = 0;
+}
+
+void VisitedPoints::save_state(BinaryWriter& writer) const {
+    writer.write(_exact);
+    writer.write<std::uint64_t>(_size);
+    if (_exact) {
+        for (auto key : _keys.keys()) writer.write<std::uint64_t>(key);
+    } else {
+        writer.write<std::uint64_t>(_filter_words.size());
+        for (auto word : _filter_words) writer.write<std::uint64_t>(word);
+    }
+}
+
+void VisitedPoints::load_state(BinaryReader& reader) {
+    if (reader.read<bool>() != _exact)
+        throw DeserialisationException("Saved visited points use a different kind of memory");
+    clear();
+    auto size = static_cast<size_t>(reader.read<std::uint64_t>());
+    if (_exact) {
+        for (size_t i=0; i<size; ++i) _keys.insert(reader.read<std::uint64_t>());
+    } else {
+        auto num_words = static_cast<size_t>(reader.read<std::uint64_t>());
+        if (num_words != _filter_words.size())
+            throw DeserialisationException("Saved visited points have " + std::to_string(num_words) + " filter words, expected " + std::to_string(_filter_words.size()));
+        for (auto& word : _filter_words) word = reader.read<std::uint64_t>();
+    }
+    _size = size;
+}
+
+} // namespace pExplore
@@ -0,0 +1,181 @@
+/***************************************************************************
+ *            warm_start.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include "helper/macros.hpp"
+#include "conclog/logging.hpp"
+#include "search_point_key.hpp"
+#include "warm_start.hpp"
+
+namespace pExplore {
+
+using ConcLog::Logger;
+
+ostream& WarmStartEntry::_write(ostream& os) const {
+    return os << "{" << coordinates << ": count=" << count << ", mean_objective=" << mean_objective << "}";
+}
+
+WarmStartStore::WarmStartStore(String const& directory, size_t max_entries) : _directory(directory), _max_entries(max_entries) {
+    HELPER_PRECONDITION(max_entries > 0)
+}
+
+String const& WarmStartStore::directory() const {
+    return _directory;
+}
+
+String WarmStartStore::signature(ConfigurationSearchSpace const& space, String const& tag) {
+    std::ostringstream ss;
+    ss << tag;
+    for (auto const& p : space.parameters()) {
+        ss << "|" << p.path() << ":";
+        for (auto v : p.values()) ss << v << ",";
+    }
+    return ss.str();
+}
+
+String WarmStartStore::_file_for(String const& signature) const {
+    // FNV-1a, to have names that are stable across compilers
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (auto c : signature) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    std::ostringstream ss;
+    ss << "pexplore_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".txt";
+    return (std::filesystem::path(_directory) / ss.str()).string();
+}
+
+List<WarmStartEntry> WarmStartStore::_load(String const& signature) const {
+    List<WarmStartEntry> result;
+    std::ifstream file(_file_for(signature));
+    if (not file.is_open()) return result;
+    String saved_signature;
+    std::getline(file,saved_signature);
+    if (saved_signature != signature) {
+        CONCLOG_PRINTLN_AT(1,"Warm-start file " << _file_for(signature) << " belongs to a different problem, ignoring it.");
+        return result;
+    }
+    String line;
+    while (std::getline(file,line)) {
+        std::istringstream ls(line);
+        size_t count;
+        double mean_objective;
+        if (not (ls >> count >> mean_objective)) continue;
+        List<int> coordinates;
+        int c;
+        while (ls >> c) coordinates.push_back(c);
+        result.push_back(WarmStartEntry(coordinates,count,mean_objective));
+    }
+    return result;
+}
+
+List<WarmStartEntry> WarmStartStore::load(ConfigurationSearchSpace const& space, String const& tag) const {
+    return _load(signature(space,tag));
+}
+
+void WarmStartStore::save(String const& tag, List<PointScore> const& best_scores) const {
+    if (best_scores.empty()) return;
+    auto space = best_scores.front().point().space();
+    auto sig = signature(space,tag);
+    auto entries = _load(sig);
+
+    for (auto const& s : best_scores) {
+        auto coordinates = s.point().coordinates();
+        auto objective = s.score().objective();
+        auto it = std::find_if(entries.begin(),entries.end(),[&coordinates](WarmStartEntry const& e) { return e.coordinates == coordinates; });
+        if (it == entries.end()) {
+            entries.push_back(WarmStartEntry(coordinates,1,objective));
+        } else {
+            it->mean_objective += (objective-it->mean_objective)/static_cast<double>(it->count+1);
+            ++it->count;
+        }
+    }
+    std::stable_sort(entries.begin(),entries.end(),[](WarmStartEntry const& a, WarmStartEntry const& b) { return a.count > b.count; });
+    if (entries.size() > _max_entries) entries.erase(entries.begin()+static_cast<std::ptrdiff_t>(_max_entries),entries.end());
+
+    std::filesystem::create_directories(_directory);
+    auto filename = _file_for(sig);
+    auto temporary = filename + ".tmp";
+    {
+        std::ofstream file(temporary);
+        file << sig << "\n" << std::setprecision(17);
+        for (auto const& e : entries) {
+            file << e.count << " " << e.mean_objective;
+            for (auto c : e.coordinates) file << " " << c;
+            file << "\n";
+        }
+    }
+    std::filesystem::rename(temporary,filename);
+}
+
+WarmStartInitialisation::WarmStartInitialisation(WarmStartStore const& store, String const& tag, InitialisationInterface const& fallback)
+    : _store(store), _tag(tag), _fallback(fallback.clone()), _generator(make_random_seed()) { }
+
+Set<ConfigurationSearchPoint> WarmStartInitialisation::initial_points(ConfigurationSearchPoint const& initial_point, size_t size) {
+    auto const& space = initial_point.space();
+    Set<ConfigurationSearchPoint> result;
+    for (auto const& e : _store.load(space,_tag)) {
+        if (result.size() >= size) break;
+        result.insert(make_point_from_coordinates(space,e.coordinates));
+    }
+    CONCLOG_PRINTLN_AT(1,"Warm-started with " << result.size() << " saved points.");
+    if (result.size() < size) {
+        for (auto const& p : _fallback->initial_points(initial_point,size)) {
+            if (result.size() >= size) break;
+            result.insert(p);
+        }
+    }
+    if (result.size() < size) result = make_extended_set_by_shifting(result,size,_generator);
+    return result;
+}
+
+void WarmStartInitialisation::set_seed(std::uint64_t seed) {
+    _generator.seed(seed);
+    _fallback->set_seed(derive_seed(seed,1));
+}
+
+void WarmStartInitialisation::save_state(BinaryWriter& writer) const {
+    write_generator(writer,_generator);
+    _fallback->save_state(writer);
+}
+
+void WarmStartInitialisation::load_state(BinaryReader& reader) {
+    read_generator(reader,_generator);
+    _fallback->load_state(reader);
+}
+
+InitialisationInterface* WarmStartInitialisation::clone() const {
+    return new WarmStartInitialisation(_store,_tag,*_fallback);
+}
+
+} // namespace pExplore
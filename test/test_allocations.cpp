@@ -0,0 +1,344 @@
+/***************************************************************************
+ *            test_allocations.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include "helper/test.hpp"
+#include "pronest/searchable_configuration.hpp"
+#include "pronest/configuration_property.tpl.hpp"
+#include "pronest/configuration_search_space.hpp"
+#include "pronest/configurable.tpl.hpp"
+#include "task_runner_interface.hpp"
+#include "task.tpl.hpp"
+#include "task_runner.tpl.hpp"
+#include "island.hpp"
+
+using namespace std;
+using namespace ProNest;
+using namespace Helper;
+using namespace pExplore;
+
+//! \brief The number of allocations through the global operator new, from any thread
+std::atomic<size_t> num_allocations(0);
+//! \brief The number of bytes requested through the global operator new, from any thread
+std::atomic<size_t> num_allocated_bytes(0);
+
+// GCC reports free() as mismatched with the replaced operator new, if the deallocations are inlined
+#if defined(__GNUC__)
+#define DEALLOCATION_NOINLINE __attribute__((noinline))
+#else
+#define DEALLOCATION_NOINLINE
+#endif
+
+void* operator new(std::size_t size) {
+    ++num_allocations;
+    num_allocated_bytes += size;
+    if (auto p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+DEALLOCATION_NOINLINE void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+DEALLOCATION_NOINLINE void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+DEALLOCATION_NOINLINE void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+DEALLOCATION_NOINLINE void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+//! \brief The allocations made while running some code
+struct AllocationCount {
+    size_t allocations;
+    size_t bytes;
+};
+
+template<class F> AllocationCount count_allocations(F const& f) {
+    size_t allocations = num_allocations;
+    size_t bytes = num_allocated_bytes;
+    f();
+    return {num_allocations - allocations, num_allocated_bytes - bytes};
+}
+
+//! \brief Kept alive so that the allocation for it cannot be elided
+List<int> allocation_sink;
+
+class L;
+
+namespace ProNest {
+
+template<> struct Configuration<L> : public SearchableConfiguration {
+  public:
+    Configuration() { add_property("order",RangeConfigurationProperty<int>(1)); }
+    int const& order() const { return at<RangeConfigurationProperty<int>>("order").get(); }
+    void set_order(int const& lower, int const& upper) { at<RangeConfigurationProperty<int>>("order").set(lower,upper); }
+};
+
+}
+
+namespace pExplore {
+
+template<> struct TaskInput<L> {
+    double x;
+};
+
+template<> struct TaskOutput<L> {
+    double y;
+};
+
+//! \brief A task allocating nothing by itself, so that only the allocations of the library are counted
+template<> struct Task<L> final: public ParameterSearchTaskBase<L> {
+    TaskOutput<L> run(TaskInput<L> const& in, Configuration<L> const& cfg) const override {
+        return {in.x * cfg.order()};
+    }
+};
+
+}
+
+//! \brief An exploration keeping the points scored, so that the allocations of the runner are counted apart from those of
+//! choosing the next points, which are random
+class KeepPointsExploration : public ExplorationInterface {
+  public:
+    Set<ConfigurationSearchPoint> next_points_from(List<PointScore> const& scores) override {
+        Set<ConfigurationSearchPoint> result;
+        for (auto const& s : scores) result.insert(s.point());
+        return result;
+    }
+    void set_seed(std::uint64_t) override { }
+    KeepPointsExploration* clone() const override { return new KeepPointsExploration(*this); }
+};
+
+class L : public TaskRunnable<L> {
+public:
+    L(Configuration<L> const& config) : TaskRunnable<L>(config) { }
+    using TaskRunnable<L>::runner;
+};
+
+//! \brief A budget for a push/pull cycle of a concurrent runner, for each point evaluated and for each step
+//! \details The point copies are in multiples of the allocations and bytes for copying a point of the search space
+struct CycleBudget {
+    size_t point_copies_per_point;
+    size_t allocations_per_point;
+    size_t bytes_per_point;
+    size_t allocations_per_step;
+    size_t bytes_per_step;
+};
+
+class TestAllocations {
+    //! \brief Budgets for evaluating a constraining state: the sets of the evaluation and their copies in the score
+    static constexpr size_t EVALUATION_ALLOCATIONS_PER_CONSTRAINT = 2;
+    //! \brief Budgets for a push/pull cycle of a sequential runner: the output kept for pulling, and the scores appended
+    static constexpr size_t SEQUENTIAL_CYCLE_ALLOCATIONS = 8;
+    static constexpr size_t SEQUENTIAL_CYCLE_BYTES = 256;
+    //! \brief Budget for a cycle of a parameter search runner: the buffers of the tasks, the scores and the next points
+    //! \details The concurrent budgets are the counts measured in the steady state, hence any further allocation fails
+    static constexpr CycleBudget PARAMETER_SEARCH_CYCLE_BUDGET = {10,16,2048,21,408};
+    //! \brief Budget for a cycle of a real-time runner, whose slots are preallocated: the scores and the next points only
+    static constexpr CycleBudget REAL_TIME_CYCLE_BUDGET = {4,6,492,3,80};
+    //! \brief Budget for a cycle of a parameter search runner with worker processes, in the application process only
+    static constexpr CycleBudget PROCESS_POOL_CYCLE_BUDGET = {10,16,2048,21,408};
+    //! \brief Budget for a cycle of a parameter search runner forking a process for each task, in the application process only
+    static constexpr CycleBudget FORK_SNAPSHOT_CYCLE_BUDGET = {10,16,2084,21,408};
+    //! \brief Budget for a cycle of a parameter search runner on an island: also the message of the migrants
+    static constexpr CycleBudget ISLAND_CYCLE_BUDGET = {10,16,2048,34,1193};
+    //! \brief The cycles run before counting, which fill caches and grow buffers to their steady size
+    static constexpr size_t WARMUP_CYCLES = 5;
+    static constexpr size_t COUNTED_CYCLES = 20;
+
+    ConstraintBuilder<L> _constraint_builder(double bound) const {
+        return ConstraintBuilder<L>([bound](TaskInput<L> const&, TaskOutput<L> const& o) { return bound - o.y; });
+    }
+
+    L _get_runnable() const {
+        Configuration<L> cfg;
+        cfg.set_order(1,16);
+        return {cfg};
+    }
+
+    //! \brief The maximum allocations of a push/pull cycle of the runner of \a runnable, in the steady state
+    AllocationCount _max_cycle_allocations(L& runnable) const {
+        AllocationCount result = {0,0};
+        for (size_t i=0; i<WARMUP_CYCLES+COUNTED_CYCLES; ++i) {
+            // Scores are kept by the TaskManager, whose growth is not part of the cycle
+            TaskManager::instance().clear_scores();
+            auto count = count_allocations([&runnable]() {
+                runnable.runner()->push({2.0});
+                auto output = runnable.runner()->pull();
+                HELPER_TEST_ASSERT(output.y >= 2.0 and output.y <= 32.0)
+            });
+            if (i < WARMUP_CYCLES) continue;
+            result.allocations = std::max(result.allocations,count.allocations);
+            result.bytes = std::max(result.bytes,count.bytes);
+        }
+        TaskManager::instance().clear_scores();
+        return result;
+    }
+
+    //! \brief The allocations and bytes for copying a point of the search space of \a runnable
+    AllocationCount _point_copy_count(L const& runnable) const {
+        auto point = runnable.configuration().search_space().initial_point();
+        return count_allocations([&point]() { ConfigurationSearchPoint copy(point); });
+    }
+
+    //! \brief The allocations and bytes allowed by \a budget for a cycle evaluating \a concurrency points
+    AllocationCount _concurrent_cycle_budget(CycleBudget const& budget, size_t concurrency, AllocationCount const& point_copy) const {
+        return {concurrency*(budget.point_copies_per_point*point_copy.allocations + budget.allocations_per_point) + budget.allocations_per_step,
+                concurrency*(budget.point_copies_per_point*point_copy.bytes + budget.bytes_per_point) + budget.bytes_per_step};
+    }
+
+    //! \brief Check the cycles of the concurrent runner of type \a R with \a concurrency against \a budget
+    //! \details The points are kept by the exploration, since the allocations for choosing them depend on random shifts, and
+    //! all of them satisfy the constraint, since the scores of failures allocate differently
+    template<class R> void _check_concurrent_runner(CycleBudget const& budget, size_t concurrency,
+                                                    ExplorationInterface const& exploration = KeepPointsExploration()) const {
+        TaskManager::instance().set_concurrency_override(concurrency);
+        TaskManager::instance().set_exploration(exploration);
+        auto runnable = _get_runnable();
+        runnable.set_constraints({_constraint_builder(64.0).set_objective_impact(ConstraintObjectiveImpact::SIGNED).build()});
+        HELPER_TEST_ASSERT(std::dynamic_pointer_cast<R>(runnable.runner()) != nullptr)
+        auto count = _max_cycle_allocations(runnable);
+        auto limit = _concurrent_cycle_budget(budget,concurrency,_point_copy_count(runnable));
+        HELPER_TEST_PRINT(count.allocations)
+        HELPER_TEST_PRINT(count.bytes)
+        HELPER_TEST_PRINT(limit.allocations)
+        HELPER_TEST_PRINT(limit.bytes)
+        HELPER_TEST_ASSERT(count.allocations <= limit.allocations)
+        HELPER_TEST_ASSERT(count.bytes <= limit.bytes)
+        TaskManager::instance().set_exploration(ShiftAndKeepBestHalfExploration());
+        TaskManager::instance().clear_concurrency_override();
+    }
+
+  public:
+
+    void test_counting() {
+        auto count = count_allocations([]() { allocation_sink.resize(16); });
+        HELPER_TEST_ASSERT(count.allocations >= 1)
+        HELPER_TEST_ASSERT(count.bytes >= 16*sizeof(int))
+        HELPER_TEST_EQUALS(count_allocations([]() { }).allocations,0)
+        allocation_sink.clear();
+        allocation_sink.shrink_to_fit();
+    }
+
+    void test_constraining_state_evaluate() {
+        auto c1 = _constraint_builder(20.0).set_failure_kind(ConstraintFailureKind::HARD).set_objective_impact(ConstraintObjectiveImpact::SIGNED).build();
+        auto c2 = _constraint_builder(10.0).set_failure_kind(ConstraintFailureKind::SOFT).set_objective_impact(ConstraintObjectiveImpact::UNSIGNED).build();
+        auto c3 = _constraint_builder(5.0).build();
+        ConstrainingState<L> state({c1,c2,c3});
+        TaskInput<L> input = {2.0};
+        TaskOutput<L> output = {8.0};
+
+        auto score_count = count_allocations([&]() { auto score = state.evaluate(input,output,false); });
+        HELPER_TEST_PRINT(score_count.allocations)
+        HELPER_TEST_PRINT(score_count.bytes)
+        HELPER_TEST_ASSERT(score_count.allocations <= EVALUATION_ALLOCATIONS_PER_CONSTRAINT*3)
+
+        auto runnable = _get_runnable();
+        auto point = runnable.configuration().search_space().initial_point();
+        auto point_copy_allocations = _point_copy_count(runnable).allocations;
+        auto point_score_count = count_allocations([&]() { auto point_score = state.evaluate(point,input,output); });
+        HELPER_TEST_PRINT(point_copy_allocations)
+        HELPER_TEST_PRINT(point_score_count.allocations)
+        // The point score also copies the point and the score
+        HELPER_TEST_ASSERT(point_score_count.allocations <= (EVALUATION_ALLOCATIONS_PER_CONSTRAINT+1)*3 + point_copy_allocations)
+    }
+
+    void test_sequential_runner() {
+        TaskManager::instance().set_concurrency_override(1);
+        auto runnable = _get_runnable();
+        runnable.set_constraints({_constraint_builder(20.0).set_objective_impact(ConstraintObjectiveImpact::SIGNED).build()});
+        auto count = _max_cycle_allocations(runnable);
+        HELPER_TEST_PRINT(count.allocations)
+        HELPER_TEST_PRINT(count.bytes)
+        HELPER_TEST_ASSERT(count.allocations <= SEQUENTIAL_CYCLE_ALLOCATIONS)
+        HELPER_TEST_ASSERT(count.bytes <= SEQUENTIAL_CYCLE_BYTES)
+        TaskManager::instance().clear_concurrency_override();
+    }
+
+    void test_parameter_search_runner() {
+        _check_concurrent_runner<ParameterSearchRunner<L>>(PARAMETER_SEARCH_CYCLE_BUDGET,4);
+    }
+
+    void test_real_time_runner() {
+        TaskManager::instance().set_step_budget(std::chrono::seconds(1));
+        _check_concurrent_runner<RealTimeRunner<L>>(REAL_TIME_CYCLE_BUDGET,4);
+        TaskManager::instance().clear_step_budget();
+    }
+
+    void test_process_pool_runner() {
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+        // Only the allocations of the application process are counted, not those of the workers
+        TaskManager::instance().set_isolation(RunnerIsolation::PROCESS);
+        _check_concurrent_runner<ProcessPoolRunner<L>>(PROCESS_POOL_CYCLE_BUDGET,4);
+        TaskManager::instance().set_isolation(RunnerIsolation::THREAD);
+#endif
+    }
+
+    void test_fork_snapshot_runner() {
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+        TaskManager::instance().set_isolation(RunnerIsolation::FORK);
+        _check_concurrent_runner<ForkSnapshotRunner<L>>(FORK_SNAPSHOT_CYCLE_BUDGET,4);
+        TaskManager::instance().set_isolation(RunnerIsolation::THREAD);
+#endif
+    }
+
+    void test_island() {
+#if defined(PEXPLORE_HAS_ISLANDS)
+        // With no peers, the message of the migrants is built at each step but sent nowhere
+        auto channel = std::make_shared<IslandChannel>("tcp:127.0.0.1:0");
+        _check_concurrent_runner<ParameterSearchRunner<L>>(ISLAND_CYCLE_BUDGET,4,IslandExploration(KeepPointsExploration(),channel));
+#endif
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_counting())
+        HELPER_TEST_CALL(test_constraining_state_evaluate())
+        HELPER_TEST_CALL(test_sequential_runner())
+        HELPER_TEST_CALL(test_parameter_search_runner())
+        HELPER_TEST_CALL(test_real_time_runner())
+        HELPER_TEST_CALL(test_process_pool_runner())
+        HELPER_TEST_CALL(test_fork_snapshot_runner())
+        HELPER_TEST_CALL(test_island())
+    }
+};
+
+int main() {
+    TestAllocations().test();
+    return HELPER_TEST_FAILURES;
+}
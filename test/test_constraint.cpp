@@ -29,6 +29,8 @@
 #include "helper/test.hpp"
 #include "helper/array.hpp"
 #include "constraint.hpp"
+#include "constraining_state.hpp"
+#include "static_constraint.hpp"
 #include "task_runner_interface.hpp"
 
 using namespace pExplore;
@@ -52,6 +54,13 @@ template<> struct TaskOutput<R> {
 typedef TaskInput<R> I;
 typedef TaskOutput<R> O;
 
+//! \brief A controller derived from another one, which a static constraint for the base controller would not apply
+class NegatingRobustnessController : public IdentityRobustnessController<R> {
+  public:
+    double apply(double robustness, I const&, O const&, bool) override { return -robustness; }
+    RobustnessControllerInterface<R>* clone() const override { return new NegatingRobustnessController(); }
+};
+
 class TestConstraint {
   public:
 
@@ -87,9 +96,69 @@ class TestConstraint {
         HELPER_TEST_EQUALS(robustness,9)
     }
 
+    void test_static_constraint_set() {
+        auto f1 = [](I const& input, O const& output) { return static_cast<double>(output.o - input.i1); };
+        auto f2 = [](I const& input, O const& output) { return static_cast<double>(input.i2.at(0) - output.o); };
+        auto f3 = [](I const& input, O const&) { return static_cast<double>(input.i2.at(1)); };
+        auto t = [](I const& input, O const&) { return static_cast<double>(input.i1); };
+        TimeProgressLinearRobustnessController<R> controller(t,10.0);
+
+        auto c1 = ConstraintBuilder<R>(f1).set_group_id(1).set_success_action(ConstraintSuccessAction::DEACTIVATE)
+                .set_failure_kind(ConstraintFailureKind::HARD).set_objective_impact(ConstraintObjectiveImpact::SIGNED).build();
+        auto c2 = ConstraintBuilder<R>(f2).set_failure_kind(ConstraintFailureKind::SOFT).set_objective_impact(ConstraintObjectiveImpact::UNSIGNED).build();
+        auto c3 = ConstraintBuilder<R>(f3).set_objective_impact(ConstraintObjectiveImpact::SIGNED).set_controller(controller).build();
+        ConstrainingState<R> dynamic_state({c1,c2,c3});
+
+        StaticConstraintSet set(make_static_constraint<R,ConstraintFailureKind::HARD,ConstraintObjectiveImpact::SIGNED>(f1).set_group_id(1).set_success_action(ConstraintSuccessAction::DEACTIVATE),
+                                make_static_constraint<R,ConstraintFailureKind::SOFT,ConstraintObjectiveImpact::UNSIGNED>(f2),
+                                make_static_constraint<R,ConstraintFailureKind::NONE,ConstraintObjectiveImpact::SIGNED>(f3,controller));
+        HELPER_TEST_EQUALS(set.size(),3)
+        HELPER_TEST_ASSERT(set.is_compatible_with({c1,c2,c3}))
+        HELPER_TEST_ASSERT(not set.is_compatible_with({c2,c1,c3}))
+        HELPER_TEST_ASSERT(not set.is_compatible_with({c1,c2}))
+        auto derived_c2 = ConstraintBuilder<R>(f2).set_failure_kind(ConstraintFailureKind::SOFT).set_objective_impact(ConstraintObjectiveImpact::UNSIGNED)
+                .set_controller(NegatingRobustnessController()).build();
+        HELPER_TEST_ASSERT(not set.is_compatible_with({c1,derived_c2,c3}))
+
+        auto static_state = set.constraining_state();
+        HELPER_TEST_ASSERT(static_state.evaluator() != nullptr)
+        HELPER_TEST_EQUALS(static_state.states().size(),3)
+        HELPER_TEST_EQUALS(static_state.states().at(0).constraint().group_id(),1)
+
+        auto input = I(2,{1,2});
+        auto output = O(7);
+        auto static_score = static_state.evaluate(input,output,false);
+        auto dynamic_score = dynamic_state.evaluate(input,output,false);
+        HELPER_TEST_PRINT(static_score)
+        HELPER_TEST_ASSERT(static_score == dynamic_score)
+        HELPER_TEST_EQUALS(static_score.successes(),dynamic_score.successes())
+        HELPER_TEST_EQUALS(static_score.objective(),13.0)
+
+        // The success of the first constraint deactivates it, while the controller of the third is updated
+        static_state.update_from(input,output);
+        dynamic_state.update_from(input,output);
+        HELPER_TEST_ASSERT(not static_state.states().at(0).is_active())
+        HELPER_TEST_EQUALS(static_state.states().at(2).constraint().controller().state(),dynamic_state.states().at(2).constraint().controller().state())
+
+        auto later_input = I(4,{1,2});
+        auto static_later_score = static_state.evaluate(later_input,output,false);
+        auto dynamic_later_score = dynamic_state.evaluate(later_input,output,false);
+        HELPER_TEST_PRINT(static_later_score)
+        HELPER_TEST_ASSERT(static_later_score == dynamic_later_score)
+        HELPER_TEST_ASSERT(not static_later_score.successes().contains(0))
+        HELPER_TEST_EQUALS(static_later_score.objective(),dynamic_later_score.objective())
+        HELPER_TEST_ASSERT(static_later_score.objective() != 8.0)
+
+        // Clones keep the evaluator, with their own controllers
+        auto clone = static_state.clone();
+        HELPER_TEST_ASSERT(clone.evaluator() == static_state.evaluator())
+        HELPER_TEST_ASSERT(clone.evaluate(later_input,output,false) == static_later_score)
+    }
+
     void test() {
         HELPER_TEST_CALL(test_create_empty_constraint())
         HELPER_TEST_CALL(test_create_filled_constraint())
+        HELPER_TEST_CALL(test_static_constraint_set())
     }
 };
 
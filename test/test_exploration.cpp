@@ -0,0 +1,465 @@
+/***************************************************************************
+ *            test_exploration.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include "helper/test.hpp"
+#include "pronest/configuration_search_space.hpp"
+#include "exploration.hpp"
+#include "initialisation.hpp"
+#include "island.hpp"
+#include "search_point_key.hpp"
+#include "serialisation.hpp"
+#include "shared_memory.hpp"
+#include "shifting.hpp"
+#include "simulator.hpp"
+#include "trace.hpp"
+#include "visited_points.hpp"
+#include "warm_start.hpp"
+
+using namespace pExplore;
+using namespace ProNest;
+using namespace Helper;
+
+class TestExploration {
+  public:
+
+    static ConfigurationSearchSpace _get_space() {
+        ConfigurationPropertyPath use_subdivisions("use_subdivisions");
+        ConfigurationPropertyPath sweep_threshold("sweep_threshold");
+        ConfigurationSearchParameter bp(use_subdivisions, false, List<int>({0, 1}));
+        ConfigurationSearchParameter mp(sweep_threshold, true, List<int>({3, 4, 5, 6, 7}));
+        return ConfigurationSearchSpace({bp, mp});
+    }
+
+    static List<PointScore> _get_scores(ConfigurationSearchSpace const& space) {
+        List<PointScore> result;
+        result.push_back(PointScore(make_point_from_coordinates(space,{0,3}), {{}, {}, {}, 4.0}));
+        result.push_back(PointScore(make_point_from_coordinates(space,{0,4}), {{}, {}, {}, 1.0}));
+        result.push_back(PointScore(make_point_from_coordinates(space,{1,3}), {{}, {}, {}, 3.0}));
+        result.push_back(PointScore(make_point_from_coordinates(space,{1,4}), {{}, {}, {}, 2.0}));
+        return result;
+    }
+
+    static void test_visited_points_exact() {
+        auto space = _get_space();
+        VisitedPoints visited(space);
+        HELPER_TEST_ASSERT(visited.is_exact())
+        auto point = make_point_from_coordinates(space,{1,5});
+        HELPER_TEST_ASSERT(not visited.contains(point))
+        visited.insert(point);
+        visited.insert(point);
+        HELPER_TEST_ASSERT(visited.contains(point))
+        HELPER_TEST_EQUALS(visited.size(),1)
+        visited.clear();
+        HELPER_TEST_ASSERT(not visited.contains(point))
+    }
+
+    static void test_visited_points_filter() {
+        auto space = _get_space();
+        VisitedPoints visited(space,0,1024);
+        HELPER_TEST_ASSERT(not visited.is_exact())
+        auto point1 = make_point_from_coordinates(space,{1,5});
+        auto point2 = make_point_from_coordinates(space,{0,7});
+        visited.insert(point1);
+        visited.insert(point2);
+        HELPER_TEST_ASSERT(visited.contains(point1))
+        HELPER_TEST_ASSERT(visited.contains(point2))
+        HELPER_TEST_EQUALS(visited.size(),2)
+    }
+
+    static void test_shift_prefers_unvisited() {
+        auto space = _get_space();
+        auto scores = _get_scores(space);
+        ShiftAndKeepBestHalfExploration exploration;
+        auto points = exploration.next_points_from(scores);
+        HELPER_TEST_PRINT(points)
+        HELPER_TEST_EQUALS(points.size(),scores.size())
+        HELPER_TEST_ASSERT(points.contains(make_point_from_coordinates(space,{0,4})))
+        HELPER_TEST_ASSERT(points.contains(make_point_from_coordinates(space,{1,4})))
+        HELPER_TEST_ASSERT(not points.contains(make_point_from_coordinates(space,{0,3})))
+        HELPER_TEST_ASSERT(not points.contains(make_point_from_coordinates(space,{1,3})))
+        HELPER_TEST_EQUALS(exploration.visited()->size(),4)
+    }
+
+    static void test_latin_hypercube_initialisation() {
+        auto space = _get_space();
+        auto initial_point = make_point_from_coordinates(space,{0,3});
+
+        LatinHypercubeInitialisation including;
+        auto points = including.initial_points(initial_point,5);
+        HELPER_TEST_PRINT(points)
+        HELPER_TEST_EQUALS(points.size(),5)
+        HELPER_TEST_ASSERT(points.contains(initial_point))
+
+        LatinHypercubeInitialisation excluding(false);
+        auto all_points = excluding.initial_points(initial_point,10);
+        HELPER_TEST_EQUALS(all_points.size(),10)
+
+        Set<int> thresholds;
+        for (auto const& p : excluding.initial_points(initial_point,5)) thresholds.insert(p.coordinates()[1]);
+        HELPER_TEST_EQUALS(thresholds.size(),5)
+    }
+
+    static void test_surrogate_model() {
+        auto space = _get_space();
+        auto scores = _get_scores(space);
+        SurrogateModelExploration exploration;
+        auto points = exploration.next_points_from(scores);
+        HELPER_TEST_PRINT(points)
+        HELPER_TEST_EQUALS(points.size(),scores.size())
+        HELPER_TEST_EQUALS(exploration.history_size(),4)
+        HELPER_TEST_ASSERT(points.contains(make_point_from_coordinates(space,{0,4})))
+        HELPER_TEST_ASSERT(points.contains(make_point_from_coordinates(space,{1,4})))
+
+        auto best = exploration.predict(make_point_from_coordinates(space,{0,4}));
+        auto worst = exploration.predict(make_point_from_coordinates(space,{0,3}));
+        auto far = exploration.predict(make_point_from_coordinates(space,{1,7}));
+        HELPER_TEST_PRINT(best)
+        HELPER_TEST_PRINT(worst)
+        HELPER_TEST_PRINT(far)
+        HELPER_TEST_ASSERT(best.first < worst.first)
+        HELPER_TEST_ASSERT(far.second > best.second)
+    }
+
+    static void test_portfolio() {
+        auto space = _get_space();
+        auto scores = _get_scores(space);
+        PortfolioExploration exploration;
+        exploration.add(ShiftAndKeepBestHalfExploration()).add(SurrogateModelExploration());
+        HELPER_TEST_EQUALS(exploration.size(),2)
+
+        auto points = exploration.next_points_from(scores);
+        HELPER_TEST_PRINT(points)
+        HELPER_TEST_EQUALS(points.size(),scores.size())
+        HELPER_TEST_ASSERT(points.contains(make_point_from_coordinates(space,{0,4})))
+        HELPER_TEST_ASSERT(points.contains(make_point_from_coordinates(space,{1,4})))
+        HELPER_TEST_PRINT(exploration.allocations())
+        HELPER_TEST_EQUALS(exploration.allocations().at(0)+exploration.allocations().at(1),2)
+
+        List<PointScore> next_scores;
+        double objective = 0.0;
+        for (auto const& p : points) next_scores.push_back(PointScore(p, {{}, {}, {}, objective++}));
+        auto next_points = exploration.next_points_from(next_scores);
+        HELPER_TEST_EQUALS(next_points.size(),scores.size())
+        auto rewards = exploration.mean_rewards();
+        HELPER_TEST_PRINT(rewards)
+        for (auto r : rewards) HELPER_TEST_ASSERT(r >= 0.0 and r <= 1.0)
+    }
+
+    static void test_contextual() {
+        auto space = _get_space();
+        auto scores = _get_scores(space);
+        ContextualExploration exploration(ShiftAndKeepBestHalfExploration(),1.0);
+
+        Set<ConfigurationSearchPoint> pending;
+        for (auto const& s : scores) pending.insert(s.point());
+
+        HELPER_TEST_EQUALS(exploration.contextualise({0.0},pending),pending)
+        exploration.next_points_from(scores);
+
+        HELPER_TEST_EQUALS(exploration.contextualise({5.0},pending),pending)
+        HELPER_TEST_EQUALS(exploration.num_contexts(),2)
+        HELPER_TEST_EQUALS(exploration.current_context(),1)
+        List<PointScore> other_scores;
+        other_scores.push_back(PointScore(make_point_from_coordinates(space,{1,7}), {{}, {}, {}, 0.0}));
+        other_scores.push_back(PointScore(make_point_from_coordinates(space,{1,6}), {{}, {}, {}, 1.0}));
+        exploration.next_points_from(other_scores);
+
+        auto restarted = exploration.contextualise({0.1},pending);
+        HELPER_TEST_PRINT(restarted)
+        HELPER_TEST_EQUALS(exploration.num_contexts(),2)
+        HELPER_TEST_EQUALS(exploration.current_context(),0)
+        HELPER_TEST_EQUALS(restarted.size(),pending.size())
+        HELPER_TEST_ASSERT(restarted.contains(make_point_from_coordinates(space,{0,4})))
+    }
+
+    static void test_warm_start() {
+        auto space = _get_space();
+        auto directory = (std::filesystem::temp_directory_path() / "pexplore_test_warm_start").string();
+        std::filesystem::remove_all(directory);
+        WarmStartStore store(directory);
+        HELPER_TEST_ASSERT(store.load(space,"test").empty())
+
+        List<PointScore> best_scores;
+        best_scores.push_back(PointScore(make_point_from_coordinates(space,{1,6}), {{}, {}, {}, 1.0}));
+        best_scores.push_back(PointScore(make_point_from_coordinates(space,{1,6}), {{}, {}, {}, 3.0}));
+        best_scores.push_back(PointScore(make_point_from_coordinates(space,{0,5}), {{}, {}, {}, 2.0}));
+        store.save("test",best_scores);
+
+        auto entries = store.load(space,"test");
+        HELPER_TEST_PRINT(entries)
+        HELPER_TEST_EQUALS(entries.size(),2)
+        HELPER_TEST_EQUALS(entries.at(0).coordinates,List<int>({1,6}))
+        HELPER_TEST_EQUALS(entries.at(0).count,2)
+        HELPER_TEST_EQUALS(entries.at(0).mean_objective,2.0)
+        HELPER_TEST_ASSERT(store.load(space,"other").empty())
+
+        WarmStartInitialisation initialisation(store,"test");
+        auto initial_point = make_point_from_coordinates(space,{0,3});
+        auto points = initialisation.initial_points(initial_point,4);
+        HELPER_TEST_PRINT(points)
+        HELPER_TEST_EQUALS(points.size(),4)
+        HELPER_TEST_ASSERT(points.contains(make_point_from_coordinates(space,{1,6})))
+        HELPER_TEST_ASSERT(points.contains(make_point_from_coordinates(space,{0,5})))
+
+        std::filesystem::remove_all(directory);
+    }
+
+    static void test_state_round_trip() {
+        auto space = _get_space();
+        auto scores = _get_scores(space);
+
+        BinaryWriter score_writer;
+        write_point_score(score_writer,scores.at(1));
+        BinaryReader score_reader(score_writer.data());
+        auto point_score = read_point_score(score_reader,space);
+        HELPER_TEST_ASSERT(score_reader.at_end())
+        HELPER_TEST_EQUALS(point_score.point(),scores.at(1).point())
+        HELPER_TEST_EQUALS(point_score.score().objective(),scores.at(1).score().objective())
+
+        // Data from outside the process, such as island messages, is rejected rather than trusted
+        auto is_rejected = [](String const& data, auto const& read) {
+            BinaryReader reader(data);
+            try { read(reader); } catch (DeserialisationException const&) { return true; }
+            return false;
+        };
+        BinaryWriter forged_size_writer;
+        forged_size_writer.write<std::uint64_t>((std::uint64_t(1) << 61) + 1);
+        forged_size_writer.write<std::uint64_t>(0);
+        HELPER_TEST_ASSERT(is_rejected(forged_size_writer.data(),[](BinaryReader& reader) { reader.read_sizes(); }))
+        HELPER_TEST_ASSERT(is_rejected(forged_size_writer.data(),[](BinaryReader& reader) { reader.read_doubles(); }))
+        HELPER_TEST_ASSERT(is_rejected(forged_size_writer.data(),[](BinaryReader& reader) { reader.read_string(); }))
+        BinaryWriter forged_point_writer;
+        forged_point_writer.write(List<int>({0,9}));
+        HELPER_TEST_ASSERT(is_rejected(forged_point_writer.data(),[&space](BinaryReader& reader) { read_point(reader,space); }))
+
+        auto initial_point = make_point_from_coordinates(space,{0,3});
+        LatinHypercubeInitialisation initialisation;
+        initialisation.initial_points(initial_point,4);
+        BinaryWriter initialisation_writer;
+        initialisation.save_state(initialisation_writer);
+        std::shared_ptr<InitialisationInterface> restored_initialisation(initialisation.clone());
+        BinaryReader initialisation_reader(initialisation_writer.data());
+        restored_initialisation->load_state(initialisation_reader);
+        HELPER_TEST_ASSERT(initialisation_reader.at_end())
+        HELPER_TEST_EQUALS(restored_initialisation->initial_points(initial_point,4),initialisation.initial_points(initial_point,4))
+
+        SurrogateModelExploration surrogate;
+        surrogate.next_points_from(scores);
+        BinaryWriter surrogate_writer;
+        surrogate.save_state(surrogate_writer);
+        std::shared_ptr<SurrogateModelExploration> restored_surrogate(dynamic_cast<SurrogateModelExploration*>(surrogate.clone()));
+        BinaryReader surrogate_reader(surrogate_writer.data());
+        restored_surrogate->load_state(surrogate_reader,space);
+        HELPER_TEST_ASSERT(surrogate_reader.at_end())
+        auto point = make_point_from_coordinates(space,{1,6});
+        HELPER_TEST_EQUALS(restored_surrogate->history_size(),surrogate.history_size())
+        HELPER_TEST_EQUALS(restored_surrogate->predict(point).first,surrogate.predict(point).first)
+
+        PortfolioExploration portfolio;
+        portfolio.add(ShiftAndKeepBestHalfExploration()).add(SurrogateModelExploration());
+        auto points = portfolio.next_points_from(scores);
+        List<PointScore> next_scores;
+        double objective = 0.0;
+        for (auto const& p : points) next_scores.push_back(PointScore(p,{{},{},{},objective++}));
+        portfolio.next_points_from(next_scores);
+        BinaryWriter portfolio_writer;
+        portfolio.save_state(portfolio_writer);
+        std::shared_ptr<PortfolioExploration> restored_portfolio(dynamic_cast<PortfolioExploration*>(portfolio.clone()));
+        BinaryReader portfolio_reader(portfolio_writer.data());
+        restored_portfolio->load_state(portfolio_reader,space);
+        HELPER_TEST_ASSERT(portfolio_reader.at_end())
+        HELPER_TEST_EQUALS(restored_portfolio->mean_rewards(),portfolio.mean_rewards())
+        HELPER_TEST_EQUALS(restored_portfolio->allocations(),portfolio.allocations())
+
+        PortfolioExploration empty_portfolio;
+        BinaryReader mismatched_reader(portfolio_writer.data());
+        HELPER_TEST_FAIL(empty_portfolio.load_state(mismatched_reader,space))
+    }
+
+    static void test_seeded_shifting() {
+        auto space = _get_space();
+        Set<ConfigurationSearchPoint> sources;
+        sources.insert(make_point_from_coordinates(space,{0,3}));
+
+        RandomGenerator generator1(42);
+        RandomGenerator generator2(42);
+        auto extended1 = make_extended_set_by_shifting(sources,6,generator1);
+        auto extended2 = make_extended_set_by_shifting(sources,6,generator2);
+        HELPER_TEST_EQUALS(extended1.size(),6)
+        HELPER_TEST_ASSERT(extended1.contains(*sources.begin()))
+        HELPER_TEST_EQUALS(extended1,extended2)
+        auto all_points = make_extended_set_by_shifting(sources,space.total_points(),generator1);
+        HELPER_TEST_EQUALS(all_points.size(),space.total_points())
+
+        auto scores = _get_scores(space);
+        ShiftAndKeepBestHalfExploration exploration1;
+        ShiftAndKeepBestHalfExploration exploration2;
+        exploration1.set_seed(7);
+        exploration2.set_seed(7);
+        HELPER_TEST_EQUALS(exploration1.next_points_from(scores),exploration2.next_points_from(scores))
+
+        RandomShiftInitialisation initialisation1;
+        RandomShiftInitialisation initialisation2;
+        initialisation1.set_seed(3);
+        initialisation2.set_seed(3);
+        HELPER_TEST_EQUALS(initialisation1.initial_points(*sources.begin(),5),initialisation2.initial_points(*sources.begin(),5))
+    }
+
+    static void test_simulator() {
+        auto space = _get_space();
+        ExecutionTrace trace;
+        for (int b=0; b<=1; ++b)
+            for (int t=3; t<=7; ++t)
+                trace.add(TraceEntry({b,t},0,0.1*t,Score({},{},{},std::abs(t-6)+b)));
+        auto filename = (std::filesystem::temp_directory_path() / "pexplore_test_trace.txt").string();
+        trace.save(filename);
+        auto loaded = ExecutionTrace::load(filename);
+        std::filesystem::remove(filename);
+        HELPER_TEST_EQUALS(loaded.size(),trace.size())
+        HELPER_TEST_EQUALS(loaded.lookup({1,5},3).score.objective(),2.0)
+        HELPER_TEST_EQUALS(loaded.lookup({1,5},3).latency,0.5)
+
+        auto is_rejected = [&filename](String const& line) {
+            std::ofstream(filename) << "pexplore-trace 1\n" << line << "\n";
+            try { ExecutionTrace::load(filename); } catch (std::runtime_error const&) { return true; }
+            return false;
+        };
+        HELPER_TEST_ASSERT(is_rejected("0 0.1 1 - - - 1,x"))
+        HELPER_TEST_ASSERT(is_rejected("0 0.1 1 - - - 1,99999999999"))
+        HELPER_TEST_ASSERT(is_rejected("0 0.1 1 -1 - - 1,3"))
+        std::filesystem::remove(filename);
+
+        ExplorationSimulator simulator(loaded,ShiftAndKeepBestHalfExploration(),RandomShiftInitialisation(),2);
+        simulator.set_seed(11);
+        auto initial_point = make_point_from_coordinates(space,{1,3});
+        auto report = simulator.run(initial_point,4,6);
+        HELPER_TEST_PRINT(report)
+        HELPER_TEST_EQUALS(report.step_end_times.size(),6)
+        HELPER_TEST_ASSERT(report.time_to_best <= report.total_time)
+        HELPER_TEST_ASSERT(report.utilisation > 0.0 and report.utilisation <= 1.0)
+        HELPER_TEST_ASSERT(report.best.score().objective() <= report.step_best_scores.at(0).score().objective())
+        auto repeated = simulator.run(initial_point,4,6);
+        HELPER_TEST_EQUALS(repeated.total_time,report.total_time)
+        HELPER_TEST_EQUALS(repeated.best.point(),report.best.point())
+    }
+
+    static void test_islands() {
+#if defined(PEXPLORE_HAS_ISLANDS)
+        auto space = _get_space();
+        auto path = (std::filesystem::temp_directory_path() / "pexplore_test_island.sock").string();
+        // Left by an interrupted run, since channels do not take over existing files
+        std::filesystem::remove(path);
+        auto channel_a = std::make_shared<IslandChannel>("unix:" + path);
+        auto channel_b = std::make_shared<IslandChannel>("tcp:127.0.0.1:0");
+        channel_a->add_peer(channel_b->address());
+        channel_b->add_peer(channel_a->address());
+        HELPER_TEST_PRINT(channel_b->address())
+
+        auto wait_for_message = [](IslandChannel const& channel) {
+            for (size_t i=0; i<100 and channel.num_pending() == 0; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return channel.num_pending() > 0;
+        };
+
+        IslandExploration island_a(ShiftAndKeepBestHalfExploration(),channel_a);
+        IslandExploration island_b(ShiftAndKeepBestHalfExploration(),channel_b);
+        island_a.next_points_from(_get_scores(space));
+        HELPER_TEST_ASSERT(wait_for_message(*channel_b))
+
+        List<PointScore> worse_scores;
+        worse_scores.push_back(PointScore(make_point_from_coordinates(space,{0,6}), {{}, {}, {}, 10.0}));
+        worse_scores.push_back(PointScore(make_point_from_coordinates(space,{0,7}), {{}, {}, {}, 11.0}));
+        worse_scores.push_back(PointScore(make_point_from_coordinates(space,{1,6}), {{}, {}, {}, 12.0}));
+        worse_scores.push_back(PointScore(make_point_from_coordinates(space,{1,7}), {{}, {}, {}, 13.0}));
+        auto points = island_b.next_points_from(worse_scores);
+        HELPER_TEST_PRINT(points)
+        HELPER_TEST_EQUALS(points.size(),worse_scores.size())
+        HELPER_TEST_EQUALS(island_b.num_immigrants(),1)
+        HELPER_TEST_ASSERT(points.contains(make_point_from_coordinates(space,{0,4})))
+        HELPER_TEST_ASSERT(wait_for_message(*channel_a))
+
+        // The socket file of a live island is not taken over
+        HELPER_TEST_FAIL(IslandChannel("unix:" + path))
+        HELPER_TEST_ASSERT(std::filesystem::exists(path))
+
+        // Sending returns at once, even with a peer that is not reachable
+        channel_a->add_peer("unix:" + path + ".missing");
+        HELPER_TEST_EQUALS(channel_a->peers().size(),2)
+        channel_a->send(worse_scores);
+        channel_a->send(worse_scores);
+        for (size_t i=0; i<100 and channel_a->num_queued() > 0; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        HELPER_TEST_EQUALS(channel_a->num_queued(),0)
+        for (size_t i=0; i<100 and channel_b->num_pending() < 2; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        HELPER_TEST_EQUALS(channel_b->receive(space).size(),2*worse_scores.size())
+
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+        // An island in another process, whose queued message is sent before its channel is destroyed
+        auto pid = fork_process([&]() {
+            IslandChannel channel("tcp:127.0.0.1:0");
+            channel.add_peer(channel_b->address());
+            channel.send(worse_scores);
+            return 0;
+        });
+        wait_process(pid);
+        HELPER_TEST_ASSERT(wait_for_message(*channel_b))
+        HELPER_TEST_EQUALS(channel_b->receive(space).size(),worse_scores.size())
+#endif
+
+        // The socket file is removed with the channel
+        {
+            IslandChannel channel_c("unix:" + path + ".c");
+            HELPER_TEST_ASSERT(std::filesystem::exists(path + ".c"))
+        }
+        HELPER_TEST_ASSERT(not std::filesystem::exists(path + ".c"))
+#endif
+    }
+
+    static void test() {
+        HELPER_TEST_CALL(test_visited_points_exact())
+        HELPER_TEST_CALL(test_visited_points_filter())
+        HELPER_TEST_CALL(test_shift_prefers_unvisited())
+        HELPER_TEST_CALL(test_latin_hypercube_initialisation())
+        HELPER_TEST_CALL(test_surrogate_model())
+        HELPER_TEST_CALL(test_portfolio())
+        HELPER_TEST_CALL(test_contextual())
+        HELPER_TEST_CALL(test_warm_start())
+        HELPER_TEST_CALL(test_state_round_trip())
+        HELPER_TEST_CALL(test_seeded_shifting())
+        HELPER_TEST_CALL(test_simulator())
+        HELPER_TEST_CALL(test_islands())
+    }
+};
+
+int main() {
+    TestExploration::test();
+    return HELPER_TEST_FAILURES;
+}
@@ -84,8 +84,33 @@ class TestScore {
 
     }
 
+    static void test_best_selection() {
+        ConfigurationPropertyPath sweep_threshold("sweep_threshold");
+        ConfigurationSearchParameter mp(sweep_threshold, true, List<int>({3, 4, 5, 6, 7}));
+        ConfigurationSearchSpace space({mp});
+
+        List<PointScore> scores;
+        scores.push_back(PointScore(space.make_point({{sweep_threshold, 3}}), {{}, {}, {1}, 2.0}));
+        scores.push_back(PointScore(space.make_point({{sweep_threshold, 4}}), {{}, {}, {}, 4.0}));
+        scores.push_back(PointScore(space.make_point({{sweep_threshold, 5}}), {{}, {1}, {}, -3.0}));
+        scores.push_back(PointScore(space.make_point({{sweep_threshold, 6}}), {{}, {}, {}, 1.0}));
+        scores.push_back(PointScore(space.make_point({{sweep_threshold, 7}}), {{}, {}, {}, 3.0}));
+
+        HELPER_TEST_EQUALS(best_score_index(scores),3)
+
+        auto best_two = best_score_indices(scores,2);
+        HELPER_TEST_EQUALS(best_two.size(),2)
+        Set<size_t> best_two_set;
+        for (auto idx : best_two) best_two_set.insert(idx);
+        HELPER_TEST_ASSERT(best_two_set.contains(3))
+        HELPER_TEST_ASSERT(best_two_set.contains(4))
+
+        HELPER_TEST_EQUALS(best_score_indices(scores,5).size(),5)
+    }
+
     static void test() {
         HELPER_TEST_CALL(test_ranking())
+        HELPER_TEST_CALL(test_best_selection())
     }
 };
 
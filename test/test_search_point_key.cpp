@@ -0,0 +1,99 @@
+/***************************************************************************
+ *            test_search_point_key.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of pExplore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "helper/test.hpp"
+#include "pronest/configuration_search_space.hpp"
+#include "search_point_key.hpp"
+
+using namespace pExplore;
+using namespace ProNest;
+using namespace Helper;
+
+class TestSearchPointKey {
+  public:
+
+    static ConfigurationSearchSpace _get_space() {
+        ConfigurationPropertyPath use_subdivisions("use_subdivisions");
+        ConfigurationPropertyPath sweep_threshold("sweep_threshold");
+        ConfigurationPropertyPath maximum_order("maximum_order");
+        ConfigurationSearchParameter bp(use_subdivisions, false, List<int>({0, 1}));
+        ConfigurationSearchParameter mp(sweep_threshold, true, List<int>({3, 4, 5, 6, 7}));
+        ConfigurationSearchParameter op(maximum_order, true, List<int>({-2, -1, 0, 1}));
+        return ConfigurationSearchSpace({bp, mp, op});
+    }
+
+    static void test_encode_decode() {
+        auto space = _get_space();
+        SearchPointEncoder encoder(space);
+        HELPER_TEST_ASSERT(encoder.is_exact())
+
+        auto point = make_point_from_coordinates(space,{1,5,-1});
+        HELPER_TEST_PRINT(point)
+        auto key = encoder.encode(point);
+        HELPER_TEST_PRINT(key)
+        auto decoded = encoder.decode(key);
+        HELPER_TEST_EQUALS(decoded,point)
+    }
+
+    static void test_encode_unique() {
+        auto space = _get_space();
+        SearchPointEncoder encoder(space);
+        SearchPointKeySet keys;
+        for (int b=0; b<=1; ++b)
+            for (int m=3; m<=7; ++m)
+                for (int o=-2; o<=1; ++o)
+                    HELPER_TEST_ASSERT(keys.insert(encoder.encode(List<int>({b,m,o}))))
+        HELPER_TEST_EQUALS(keys.size(),40)
+        HELPER_TEST_ASSERT(encoder.encode(List<int>({1,7,1})) < 40)
+    }
+
+    static void test_key_set() {
+        SearchPointKeySet keys(2);
+        HELPER_TEST_ASSERT(keys.empty())
+        for (SearchPointKey k=0; k<1000; k+=3) HELPER_TEST_ASSERT(keys.insert(k))
+        HELPER_TEST_ASSERT(not keys.insert(999))
+        HELPER_TEST_EQUALS(keys.size(),334)
+        HELPER_TEST_ASSERT(keys.contains(0))
+        HELPER_TEST_ASSERT(keys.contains(996))
+        HELPER_TEST_ASSERT(not keys.contains(1))
+        keys.clear();
+        HELPER_TEST_ASSERT(keys.empty())
+        HELPER_TEST_ASSERT(not keys.contains(0))
+    }
+
+    static void test() {
+        HELPER_TEST_CALL(test_encode_decode())
+        HELPER_TEST_CALL(test_encode_unique())
+        HELPER_TEST_CALL(test_key_set())
+    }
+};
+
+int main() {
+    TestSearchPointKey::test();
+    return HELPER_TEST_FAILURES;
+}
@@ -26,6 +26,17 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
 #include "helper/test.hpp"
 #include "helper/lazy.hpp"
 #include "pronest/searchable_configuration.hpp"
@@ -192,6 +203,195 @@ public:
     }
 };
 
+class V;
+
+namespace ProNest {
+
+template<> struct Configuration<V> : public SearchableConfiguration {
+  public:
+    Configuration() { add_property("order",IntegerConfigurationProperty(1)); }
+    int const& order() const { return at<IntegerConfigurationProperty>("order").get(); }
+    void set_order(int const& lower, int const& upper) { at<IntegerConfigurationProperty>("order").set(lower,upper); }
+};
+
+}
+
+//! \brief The number of configurations run by batches of more than one
+std::atomic<size_t> batched_configurations(0);
+//! \brief The addresses of the configurations run by batches, for each order
+std::mutex batched_addresses_mutex;
+std::map<int,std::set<void const*>> batched_addresses;
+
+namespace pExplore {
+
+template<> struct TaskInput<V> {
+    double x;
+};
+
+template<> struct TaskOutput<V> {
+    double y;
+};
+
+template<> struct Task<V> final: public ParameterSearchTaskBase<V> {
+    TaskOutput<V> run(TaskInput<V> const& in, Configuration<V> const& cfg) const override {
+        return {in.x * cfg.order()};
+    }
+    List<TaskOutput<V>> run_batch(TaskInput<V> const& in, std::span<Configuration<V> const* const> cfgs) const override {
+        if (cfgs.size() > 1) batched_configurations += cfgs.size();
+        List<TaskOutput<V>> result;
+        std::lock_guard<std::mutex> lock(batched_addresses_mutex);
+        for (auto cfg : cfgs) {
+            batched_addresses[cfg->order()].insert(cfg);
+            result.push_back({in.x * cfg->order()});
+        }
+        return result;
+    }
+    size_t max_batch_size() const override { return 4; }
+};
+
+}
+
+class V : public TaskRunnable<V> {
+public:
+    V(Configuration<V> const& config) : TaskRunnable<V>(config) { }
+    using TaskRunnable<V>::runner;
+};
+
+class S;
+
+namespace ProNest {
+
+template<> struct Configuration<S> : public SearchableConfiguration {
+  public:
+    Configuration() { add_property("order",IntegerConfigurationProperty(1)); }
+    int const& order() const { return at<IntegerConfigurationProperty>("order").get(); }
+    void set_order(int const& lower, int const& upper) { at<IntegerConfigurationProperty>("order").set(lower,upper); }
+};
+
+}
+
+namespace pExplore {
+
+template<> struct TaskInput<S> {
+    double x;
+};
+
+template<> struct TaskOutput<S> {
+    double y;
+};
+
+//! \brief A task that takes far longer than the step budget at the highest order
+template<> struct Task<S> final: public ParameterSearchTaskBase<S> {
+    TaskOutput<S> run(TaskInput<S> const& in, Configuration<S> const& cfg) const override {
+        if (cfg.order() == 8) std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        return {in.x * cfg.order()};
+    }
+};
+
+}
+
+class S : public TaskRunnable<S> {
+public:
+    S(Configuration<S> const& config) : TaskRunnable<S>(config) { }
+    using TaskRunnable<S>::runner;
+};
+
+class H;
+
+namespace ProNest {
+
+template<> struct Configuration<H> : public SearchableConfiguration {
+  public:
+    Configuration() {
+        add_property("order",IntegerConfigurationProperty(1));
+        add_property("width",IntegerConfigurationProperty(1));
+    }
+    int const& order() const { return at<IntegerConfigurationProperty>("order").get(); }
+    void set_order(int const& lower, int const& upper) { at<IntegerConfigurationProperty>("order").set(lower,upper); }
+    void set_width(int const& lower, int const& upper) { at<IntegerConfigurationProperty>("width").set(lower,upper); }
+};
+
+}
+
+//! \brief The orders run at each fidelity
+std::mutex fidelity_runs_mutex;
+std::map<double,List<int>> fidelity_runs;
+
+namespace pExplore {
+
+template<> struct TaskInput<H> {
+    double x;
+};
+
+template<> struct TaskOutput<H> {
+    double y;
+};
+
+//! \brief A task recording the fidelity of each run
+template<> struct Task<H> final: public ParameterSearchTaskBase<H> {
+    TaskOutput<H> run(TaskInput<H> const& in, Configuration<H> const& cfg) const override {
+        return run_at_fidelity(in,cfg,1.0);
+    }
+    TaskOutput<H> run_at_fidelity(TaskInput<H> const& in, Configuration<H> const& cfg, double fidelity) const override {
+        std::lock_guard<std::mutex> lock(fidelity_runs_mutex);
+        fidelity_runs[fidelity].push_back(cfg.order());
+        return {in.x * cfg.order()};
+    }
+};
+
+}
+
+class H : public TaskRunnable<H> {
+public:
+    H(Configuration<H> const& config) : TaskRunnable<H>(config) { }
+    using TaskRunnable<H>::runner;
+};
+
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+
+class P;
+
+namespace ProNest {
+
+template<> struct Configuration<P> : public SearchableConfiguration {
+  public:
+    Configuration() { add_property("order",IntegerConfigurationProperty(1)); }
+    int const& order() const { return at<IntegerConfigurationProperty>("order").get(); }
+    void set_order(int const& lower, int const& upper) { at<IntegerConfigurationProperty>("order").set(lower,upper); }
+};
+
+}
+
+namespace pExplore {
+
+template<> struct TaskInput<P> {
+    double x;
+    int max_order;
+};
+
+template<> struct TaskOutput<P> {
+    double y;
+};
+
+template<> struct Task<P> final: public ParameterSearchTaskBase<P> {
+    TaskOutput<P> run(TaskInput<P> const& in, Configuration<P> const& cfg) const override {
+        // A negative maximum order stands for a task that never completes
+        if (in.max_order < 0) std::this_thread::sleep_for(std::chrono::hours(1));
+        if (cfg.order() > in.max_order) std::abort();
+        return {in.x * cfg.order()};
+    }
+};
+
+}
+
+class P : public TaskRunnable<P> {
+public:
+    P(Configuration<P> const& config) : TaskRunnable<P>(config) { }
+    using TaskRunnable<P>::runner;
+};
+
+#endif
+
 class TestTaskRunner {
     using I = TaskInput<A>;
     using O = TaskOutput<A>;
@@ -256,6 +456,29 @@ class TestTaskRunner {
         ThreadManager::instance().set_concurrency(1);
     }
 
+    void test_static_constraints() {
+
+        ThreadManager::instance().set_concurrency(ThreadManager::instance().maximum_concurrency());
+        TaskManager::instance().clear_scores();
+
+        auto a = _get_runnable();
+        double offset = 8.0;
+        auto distance = [offset](I const&, O const& o) { return (o.y - offset) * (o.y - offset); };
+        a.set_constraints(StaticConstraintSet(make_static_constraint<A,ConstraintFailureKind::NONE,ConstraintObjectiveImpact::SIGNED>(distance)));
+        HELPER_TEST_ASSERT(a.constraining_state().evaluator() != nullptr)
+
+        auto result = a.execute();
+        HELPER_TEST_PRINT(result)
+
+        HELPER_TEST_ASSERT(TaskManager::instance().scores().at(0).size() > 1)
+        // Restarting from another point keeps the constraints evaluated by the set
+        a.set_initial_point(a.configuration().search_space().initial_point());
+        HELPER_TEST_ASSERT(a.constraining_state().evaluator() != nullptr)
+
+        TaskManager::instance().clear_scores();
+        ThreadManager::instance().set_concurrency(1);
+    }
+
     void test_uses_expensiveclass() {
 
         ThreadManager::instance().set_concurrency(ThreadManager::instance().maximum_concurrency());
@@ -356,14 +579,650 @@ class TestTaskRunner {
         ThreadManager::instance().set_concurrency(1);
     }
 
+    void test_latin_hypercube_initialisation() {
+
+        size_t const concurrency = 4;
+        TaskManager::instance().set_concurrency_override(concurrency);
+        TaskManager::instance().set_initialisation(LatinHypercubeInitialisation());
+        TaskManager::instance().set_seed(1234);
+        TaskManager::instance().clear_scores();
+
+        // The numbers of values are multiples of the concurrency, so that each stratum has as many values
+        Configuration<H> cfg;
+        cfg.set_order(1,16);
+        cfg.set_width(1,8);
+        H h(cfg);
+        h.set_constraints({ConstraintBuilder<H>([](TaskInput<H> const&, TaskOutput<H> const& o) { return o.y; })
+                                   .set_objective_impact(ConstraintObjectiveImpact::SIGNED)
+                                   .build()});
+        HELPER_TEST_ASSERT(std::dynamic_pointer_cast<ParameterSearchRunner<H>>(h.runner()) != nullptr)
+        h.runner()->push({1.0});
+        h.runner()->pull();
+
+        auto const& space = h.configuration().search_space();
+        auto const& first_scores = TaskManager::instance().scores().at(0);
+        HELPER_TEST_EQUALS(first_scores.size(),concurrency)
+        Set<ConfigurationSearchPoint> points;
+        for (auto const& s : first_scores) points.insert(s.point());
+        HELPER_TEST_ASSERT(points.contains(TaskManager::instance().initial_point(space)))
+        for (size_t i=0; i<space.dimension(); ++i) {
+            auto values = space.parameters()[i].values();
+            std::sort(values.begin(),values.end());
+            std::set<size_t> strata;
+            for (auto const& p : points) {
+                auto position = static_cast<size_t>(std::lower_bound(values.begin(),values.end(),p.coordinates()[i])-values.begin());
+                strata.insert(position*concurrency/values.size());
+            }
+            HELPER_TEST_EQUALS(strata.size(),concurrency)
+        }
+
+        TaskManager::instance().clear_seed();
+        TaskManager::instance().clear_scores();
+        TaskManager::instance().set_initialisation(RandomShiftInitialisation());
+        TaskManager::instance().clear_concurrency_override();
+    }
+
+    void test_successive_halving() {
+
+        SuccessiveHalvingSchedule schedule({0.25,0.5},2);
+        HELPER_TEST_EQUALS(schedule.num_rungs(),3)
+        HELPER_TEST_EQUALS(schedule.rung_size(0,4),16)
+        HELPER_TEST_EQUALS(schedule.rung_size(1,4),8)
+        HELPER_TEST_EQUALS(schedule.rung_size(2,4),4)
+        HELPER_TEST_EQUALS(schedule.fidelity(2),1.0)
+
+        size_t const concurrency = 4;
+        TaskManager::instance().set_concurrency_override(concurrency);
+        TaskManager::instance().set_fidelity_schedule(schedule);
+        TaskManager::instance().clear_scores();
+
+        Configuration<H> cfg;
+        cfg.set_order(1,64);
+        H h(cfg);
+        // The lower the order, the better the score
+        h.set_constraints({ConstraintBuilder<H>([](TaskInput<H> const&, TaskOutput<H> const& o) { return o.y; })
+                                   .set_objective_impact(ConstraintObjectiveImpact::SIGNED)
+                                   .build()});
+        HELPER_TEST_ASSERT(std::dynamic_pointer_cast<ParameterSearchRunner<H>>(h.runner()) != nullptr)
+
+        // Whether the promoted orders are the lowest ones among the candidates
+        auto are_best = [](List<int> promoted, List<int> candidates) {
+            std::sort(promoted.begin(),promoted.end());
+            std::sort(candidates.begin(),candidates.end());
+            return std::equal(promoted.begin(),promoted.end(),candidates.begin());
+        };
+
+        for (size_t i=0; i<3; ++i) {
+            fidelity_runs.clear();
+            h.runner()->push({1.0});
+            auto output = h.runner()->pull();
+            HELPER_TEST_ASSERT(output.y >= 1.0)
+            HELPER_TEST_EQUALS(fidelity_runs.size(),3)
+            auto const& lowest = fidelity_runs[0.25];
+            auto const& intermediate = fidelity_runs[0.5];
+            auto const& full = fidelity_runs[1.0];
+            HELPER_TEST_EQUALS(lowest.size(),schedule.rung_size(0,concurrency))
+            HELPER_TEST_EQUALS(intermediate.size(),schedule.rung_size(1,concurrency))
+            HELPER_TEST_EQUALS(full.size(),concurrency)
+            HELPER_TEST_EQUALS(std::set<int>(lowest.begin(),lowest.end()).size(),lowest.size())
+            HELPER_TEST_ASSERT(are_best(intermediate,lowest))
+            HELPER_TEST_ASSERT(are_best(full,intermediate))
+        }
+        HELPER_TEST_EQUALS(TaskManager::instance().scores().size(),3)
+        HELPER_TEST_EQUALS(TaskManager::instance().scores().at(0).size(),concurrency)
+
+        TaskManager::instance().set_fidelity_schedule(SuccessiveHalvingSchedule());
+        TaskManager::instance().clear_scores();
+        TaskManager::instance().clear_concurrency_override();
+    }
+
+    void test_checkpoint() {
+
+        ThreadManager::instance().set_concurrency(ThreadManager::instance().maximum_concurrency());
+        auto filename = (std::filesystem::temp_directory_path() / "pexplore_test_checkpoint.bin").string();
+        TaskManager::instance().set_checkpoint_file(filename);
+        TaskManager::instance().clear_scores();
+
+        double offset = 8.0;
+        double final_time = 10.0;
+        // Each runnable gets its own constraint, since copies of a constraint share the controller
+        auto make_constraint = [offset,final_time]() {
+            return ConstraintBuilder<A>([offset](I const&, O const& o) { return (o.y - offset) * (o.y - offset); })
+                    .set_controller(TimeProgressLinearRobustnessController<A>([](I const&, O const& o) { return o.step; },final_time))
+                    .set_objective_impact(ConstraintObjectiveImpact::UNSIGNED)
+                    .build();
+        };
+        List<double> saved_controller_state;
+        {
+            auto a = _get_runnable();
+            a.set_constraints({make_constraint()});
+            a.execute();
+            saved_controller_state = a.constraining_state().states().at(0).constraint().controller().state();
+        }
+        HELPER_TEST_ASSERT(std::filesystem::exists(filename))
+        HELPER_TEST_ASSERT(std::filesystem::exists(CheckpointWriter::history_filename(filename)))
+        HELPER_TEST_EQUALS(TaskManager::instance().scores().size(),10)
+
+        TaskManager::instance().clear_scores();
+        auto b = _get_runnable();
+        b.set_constraints({make_constraint()});
+        b.restore_checkpoint(filename);
+        HELPER_TEST_EQUALS(TaskManager::instance().scores().size(),10)
+        HELPER_TEST_EQUALS(b.constraining_state().states().at(0).constraint().controller().state(),saved_controller_state)
+        b.execute();
+        HELPER_TEST_EQUALS(TaskManager::instance().scores().size(),20)
+
+        HELPER_TEST_FAIL(b.restore_checkpoint(filename + ".missing"))
+
+        auto is_rejected = [](TaskRunnable<A>& runnable, String const& checkpoint) {
+            try { runnable.restore_checkpoint(checkpoint); } catch (DeserialisationException const&) { return true; }
+            return false;
+        };
+        auto c = _get_runnable();
+        c.set_constraints({make_constraint()});
+        auto copy = filename + ".copy";
+        std::filesystem::copy_file(filename,copy,std::filesystem::copy_options::overwrite_existing);
+        HELPER_TEST_ASSERT(is_rejected(c,copy))
+        HELPER_TEST_EQUALS(c.constraining_state().states().at(0).constraint().controller().state(),List<double>({0.0,0.0}))
+        std::filesystem::remove(copy);
+
+        auto d = _get_runnable();
+        d.set_constraints({ConstraintBuilder<A>([offset](I const&, O const& o) { return o.y - offset; }).build()});
+        HELPER_TEST_ASSERT(is_rejected(d,filename))
+        HELPER_TEST_EQUALS(TaskManager::instance().scores().size(),20)
+
+        TaskManager::instance().set_checkpoint_file("");
+        TaskManager::instance().clear_scores();
+        std::filesystem::remove(filename);
+        std::filesystem::remove(CheckpointWriter::history_filename(filename));
+        ThreadManager::instance().set_concurrency(1);
+    }
+
+    void test_record_replay() {
+
+        ThreadManager::instance().set_concurrency(ThreadManager::instance().maximum_concurrency());
+        auto filename = (std::filesystem::temp_directory_path() / "pexplore_test_decisions.txt").string();
+        double offset = 8.0;
+        auto constraint = ConstraintBuilder<A>([offset](I const&, O const& o) { return (o.y - offset) * (o.y - offset); })
+                .set_objective_impact(ConstraintObjectiveImpact::SIGNED)
+                .build();
+
+        auto explored_points = []() {
+            List<Set<ConfigurationSearchPoint>> result;
+            for (auto const& step_scores : TaskManager::instance().scores()) {
+                Set<ConfigurationSearchPoint> points;
+                for (auto const& s : step_scores) points.insert(s.point());
+                result.push_back(points);
+            }
+            return result;
+        };
+
+        TaskManager::instance().clear_scores();
+        TaskManager::instance().set_seed(1234);
+        TaskManager::instance().set_decision_log(filename,DecisionLog::Mode::RECORD);
+        auto a = _get_runnable();
+        a.set_constraints({constraint});
+        a.execute();
+        auto recorded = explored_points();
+
+        TaskManager::instance().clear_scores();
+        TaskManager::instance().clear_seed();
+        TaskManager::instance().set_decision_log(filename,DecisionLog::Mode::REPLAY);
+        auto b = _get_runnable();
+        b.set_constraints({constraint});
+        b.execute();
+        auto replayed = explored_points();
+
+        HELPER_TEST_EQUALS(recorded.size(),10)
+        HELPER_TEST_ASSERT(recorded == replayed)
+
+        HELPER_TEST_FAIL(b.execute())
+
+        TaskManager::instance().clear_decision_log();
+        TaskManager::instance().clear_scores();
+
+        std::ofstream invalid(filename);
+        invalid << "pexplore-decisions 1" << std::endl << "NEXT 1,x,3" << std::endl;
+        invalid.close();
+        HELPER_TEST_FAIL(DecisionLog(filename,DecisionLog::Mode::REPLAY))
+
+        std::filesystem::remove(filename);
+        ThreadManager::instance().set_concurrency(1);
+    }
+
+    void test_seeded_runs() {
+
+        ThreadManager::instance().set_concurrency(ThreadManager::instance().maximum_concurrency());
+        double offset = 8.0;
+
+        // The points of each step, in the order given to the exploration
+        auto explored_points = [offset,this]() {
+            TaskManager::instance().clear_scores();
+            auto a = _get_runnable();
+            a.set_constraints({ConstraintBuilder<A>([offset](I const&, O const& o) { return (o.y - offset) * (o.y - offset); })
+                                       .set_objective_impact(ConstraintObjectiveImpact::SIGNED)
+                                       .build()});
+            a.execute();
+            List<List<ConfigurationSearchPoint>> result;
+            for (auto const& step_scores : TaskManager::instance().scores()) {
+                List<ConfigurationSearchPoint> points;
+                for (auto const& s : step_scores) points.push_back(s.point());
+                result.push_back(points);
+            }
+            return result;
+        };
+
+        TaskManager::instance().set_seed(1234);
+        auto first = explored_points();
+        auto second = explored_points();
+
+        HELPER_TEST_EQUALS(first.size(),10)
+        HELPER_TEST_ASSERT(first == second)
+
+        TaskManager::instance().clear_seed();
+        TaskManager::instance().clear_scores();
+        ThreadManager::instance().set_concurrency(1);
+    }
+
+    void test_concurrency_detection() {
+        HELPER_TEST_ASSERT(not cgroup_v2_cpu_limit("max 100000").has_value())
+        HELPER_TEST_EQUALS(cgroup_v2_cpu_limit("150000 100000").value(),2)
+        HELPER_TEST_EQUALS(cgroup_v2_cpu_limit("400000 100000\n").value(),4)
+        HELPER_TEST_ASSERT(not cgroup_v2_cpu_limit("").has_value())
+        HELPER_TEST_EQUALS(cgroup_v1_cpu_limit("50000\n","100000\n").value(),1)
+        HELPER_TEST_ASSERT(not cgroup_v1_cpu_limit("-1","100000").has_value())
+
+        auto available = available_concurrency();
+        HELPER_TEST_PRINT(available)
+        HELPER_TEST_ASSERT(available >= 1)
+
+        ThreadManager::instance().set_concurrency(ThreadManager::instance().maximum_concurrency());
+        HELPER_TEST_ASSERT(TaskManager::instance().search_concurrency() <= available)
+        TaskManager::instance().set_concurrency_override(3);
+        HELPER_TEST_EQUALS(TaskManager::instance().search_concurrency(),3)
+        TaskManager::instance().clear_concurrency_override();
+        ThreadManager::instance().set_concurrency(1);
+        HELPER_TEST_EQUALS(TaskManager::instance().search_concurrency(),1)
+    }
+
+    void test_affinity() {
+        HELPER_TEST_EQUALS(parse_processor_list("0-3, 8,10-11\n"),List<size_t>({0,1,2,3,8,10,11}))
+        HELPER_TEST_ASSERT(parse_processor_list("").empty())
+        HELPER_TEST_FAIL(parse_processor_list("1-x"))
+
+        // Two packages of two cores of two hardware threads, numbered as on Linux
+        List<ProcessorLocation> topology;
+        for (size_t thread=0; thread<2; ++thread)
+            for (size_t package=0; package<2; ++package)
+                for (size_t core=0; core<2; ++core)
+                    topology.push_back({thread*4+package*2+core,package,core,package});
+        HELPER_TEST_ASSERT(AffinityPolicy::none().assign(topology,4).empty())
+        HELPER_TEST_EQUALS(AffinityPolicy::compact().assign(topology,8),List<size_t>({0,1,2,3,4,5,6,7}))
+        HELPER_TEST_EQUALS(AffinityPolicy::scatter().assign(topology,8),List<size_t>({0,2,1,3,4,6,5,7}))
+        HELPER_TEST_EQUALS(AffinityPolicy::scatter().assign(topology,3),List<size_t>({0,2,1}))
+        HELPER_TEST_EQUALS(AffinityPolicy::explicit_cpus({5,7}).assign(topology,3),List<size_t>({5,7,5}))
+        HELPER_TEST_ASSERT(AffinityPolicy::compact().assign({},2).empty())
+        // The processor of a thread does not depend on the number of threads, hence threads added when resizing are placed as the policy
+        for (size_t i=0; i<8; ++i)
+            HELPER_TEST_EQUALS(AffinityPolicy::scatter().processor_for(topology,i).value(),AffinityPolicy::scatter().assign(topology,8).at(i))
+        HELPER_TEST_EQUALS(AffinityPolicy::scatter().processor_for(topology,2).value(),1)
+        HELPER_TEST_EQUALS(AffinityPolicy::explicit_cpus({5,7}).processor_for(topology,3).value(),7)
+        HELPER_TEST_ASSERT(not AffinityPolicy::none().processor_for(topology,0).has_value())
+
+        auto available = read_processor_topology();
+        HELPER_TEST_PRINT(available.size())
+        HELPER_TEST_ASSERT(available.size() <= std::thread::hardware_concurrency())
+
+        ThreadManager::instance().set_concurrency(ThreadManager::instance().maximum_concurrency());
+        TaskManager::instance().set_affinity(AffinityPolicy::compact());
+        auto a = _get_runnable();
+        auto constraint = ConstraintBuilder<A>([](I const&, O const& o) { return (o.y - 8.0) * (o.y - 8.0); })
+                .set_objective_impact(ConstraintObjectiveImpact::SIGNED)
+                .build();
+        a.set_constraints({constraint});
+        auto result = a.execute();
+        HELPER_TEST_PRINT(result)
+        TaskManager::instance().set_affinity(AffinityPolicy::none());
+        ThreadManager::instance().set_concurrency(1);
+    }
+
+    void test_batch() {
+        ThreadManager::instance().set_concurrency(ThreadManager::instance().maximum_concurrency());
+        TaskManager::instance().clear_scores();
+        batched_configurations = 0;
+        batched_addresses.clear();
+
+        Configuration<V> cfg;
+        cfg.set_order(1,16);
+        V v(cfg);
+        auto constraint = ConstraintBuilder<V>([](TaskInput<V> const&, TaskOutput<V> const& o) { return 20.0 - o.y; })
+                .set_objective_impact(ConstraintObjectiveImpact::SIGNED)
+                .build();
+        v.set_constraints({constraint});
+        // Enough steps for points to be revisited, whatever the concurrency
+        for (size_t i=0; i<20; ++i) {
+            v.runner()->push({2.0});
+            auto output = v.runner()->pull();
+            HELPER_TEST_ASSERT(output.y >= 2.0 and output.y <= 32.0)
+        }
+        auto concurrency = TaskManager::instance().search_concurrency();
+        if (concurrency > 1) {
+            HELPER_TEST_ASSERT(batched_configurations > 0)
+            for (auto const& step_scores : TaskManager::instance().scores())
+                HELPER_TEST_EQUALS(step_scores.size(),std::min<size_t>(concurrency,16))
+            // A revisited point is run with its cached configuration, rather than with a new copy
+            HELPER_TEST_ASSERT(batched_configurations > batched_addresses.size())
+            for (auto const& entry : batched_addresses)
+                HELPER_TEST_EQUALS(entry.second.size(),1)
+        }
+
+        TaskManager::instance().clear_scores();
+        ThreadManager::instance().set_concurrency(1);
+    }
+
+    void test_set_concurrency() {
+        TaskManager::instance().set_concurrency_override(4);
+        TaskManager::instance().clear_scores();
+
+        Configuration<V> cfg;
+        cfg.set_order(1,16);
+        V v(cfg);
+        auto constraint = ConstraintBuilder<V>([](TaskInput<V> const&, TaskOutput<V> const& o) { return 20.0 - o.y; })
+                .set_objective_impact(ConstraintObjectiveImpact::SIGNED)
+                .build();
+        v.set_constraints({constraint});
+        auto runner = std::dynamic_pointer_cast<ParameterSearchRunner<V>>(v.runner());
+        HELPER_TEST_ASSERT(runner != nullptr)
+        // The first change applies before activation, the others to the live search; the last one is limited by the space
+        for (auto concurrency : List<size_t>({2,5,1,3,100})) {
+            runner->set_concurrency(concurrency);
+            for (size_t i=0; i<2; ++i) {
+                runner->push({2.0});
+                auto output = runner->pull();
+                HELPER_TEST_ASSERT(output.y >= 2.0 and output.y <= 32.0)
+                HELPER_TEST_EQUALS(TaskManager::instance().scores().back().size(),std::min<size_t>(concurrency,16))
+            }
+        }
+
+        TaskManager::instance().clear_scores();
+        TaskManager::instance().clear_concurrency_override();
+    }
+
+    void test_reuse_runner() {
+        TaskManager::instance().set_concurrency_override(4);
+        TaskManager::instance().clear_scores();
+
+        Configuration<V> cfg;
+        cfg.set_order(1,16);
+        V v(cfg);
+        auto make_constraint = [](double bound) {
+            return ConstraintBuilder<V>([bound](TaskInput<V> const&, TaskOutput<V> const& o) { return bound - o.y; })
+                    .set_objective_impact(ConstraintObjectiveImpact::SIGNED)
+                    .build();
+        };
+        auto step = [&v]() {
+            v.runner()->push({2.0});
+            auto output = v.runner()->pull();
+            HELPER_TEST_ASSERT(output.y >= 2.0 and output.y <= 32.0)
+        };
+        v.set_constraints({make_constraint(20.0)});
+        auto runner = std::dynamic_pointer_cast<ParameterSearchRunner<V>>(v.runner());
+        HELPER_TEST_ASSERT(runner != nullptr)
+        step();
+
+        v.set_constraints({make_constraint(10.0)});
+        HELPER_TEST_ASSERT(v.runner() == runner)
+        step();
+        v.set_initial_point(cfg.search_space().initial_point());
+        HELPER_TEST_ASSERT(v.runner() == runner)
+        step();
+        HELPER_TEST_EQUALS(TaskManager::instance().scores().size(),3)
+
+        // A kept runner restarts from the initial point given with the constraints
+        auto last_point = make_point_from_coordinates(cfg.search_space(),{16});
+        TaskManager::instance().choose_runner_for(v,List<Constraint<V>>({make_constraint(20.0)}),last_point);
+        HELPER_TEST_ASSERT(v.runner() == runner)
+        step();
+        bool restarted = false;
+        for (auto const& s : TaskManager::instance().scores().back()) restarted = restarted or s.point() == last_point;
+        HELPER_TEST_ASSERT(restarted)
+
+        TaskManager::instance().set_concurrency_override(2);
+        v.set_constraints({make_constraint(20.0)});
+        HELPER_TEST_ASSERT(v.runner() == runner)
+        step();
+        HELPER_TEST_EQUALS(TaskManager::instance().scores().back().size(),2)
+
+        TaskManager::instance().set_exploration(ShiftAndKeepBestHalfExploration());
+        v.set_constraints({make_constraint(20.0)});
+        HELPER_TEST_ASSERT(v.runner() != runner)
+        step();
+
+        TaskManager::instance().clear_scores();
+        TaskManager::instance().clear_concurrency_override();
+    }
+
+    void test_real_time() {
+        TaskManager::instance().set_concurrency_override(4);
+        TaskManager::instance().set_step_budget(std::chrono::milliseconds(50));
+        TaskManager::instance().clear_scores();
+
+        Configuration<S> cfg;
+        cfg.set_order(1,8);
+        S s(cfg);
+        auto constraint = ConstraintBuilder<S>([](TaskInput<S> const&, TaskOutput<S> const& o) { return 20.0 - o.y; })
+                .set_objective_impact(ConstraintObjectiveImpact::SIGNED)
+                .build();
+        s.set_constraints({constraint});
+        auto runner = std::dynamic_pointer_cast<RealTimeRunner<S>>(s.runner());
+        HELPER_TEST_ASSERT(runner != nullptr)
+        for (size_t i=0; i<10; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            runner->push({2.0});
+            // At most one point per step is slow, hence some task completes in time
+            auto output = runner->pull();
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            HELPER_TEST_ASSERT(output.y >= 2.0 and output.y <= 14.0)
+            // Within the budget, with an allowance for waking up the caller
+            HELPER_TEST_ASSERT(elapsed < std::chrono::milliseconds(60))
+        }
+        HELPER_TEST_PRINT(runner->late_tasks())
+
+        TaskManager::instance().clear_step_budget();
+        TaskManager::instance().clear_scores();
+        TaskManager::instance().clear_concurrency_override();
+    }
+
+    void test_runtime_weight() {
+        TaskManager::instance().set_concurrency_override(4);
+        TaskManager::instance().set_runtime_weight(1000.0);
+        TaskManager::instance().clear_scores();
+
+        Configuration<S> cfg;
+        cfg.set_order(1,8);
+        S s(cfg);
+        // With no impact on the objective from constraints, only the running time ranks the points
+        auto constraint = ConstraintBuilder<S>([](TaskInput<S> const&, TaskOutput<S> const& o) { return 20.0 - o.y; }).build();
+        s.set_constraints({constraint});
+        // Starting from the slow point, so that the first step ranks it against fast ones
+        auto slow_point = make_point_from_coordinates(cfg.search_space(),{8});
+        HELPER_TEST_EQUALS(make_singleton(cfg,slow_point).order(),8)
+        s.set_initial_point(slow_point);
+        for (size_t i=0; i<5; ++i) {
+            s.runner()->push({2.0});
+            auto output = s.runner()->pull();
+            // At most one point per step is slow
+            HELPER_TEST_ASSERT(output.y < 16.0)
+        }
+        size_t slow_steps = 0;
+        for (auto const& step_scores : TaskManager::instance().scores()) {
+            for (auto const& score : step_scores)
+                HELPER_TEST_ASSERT(score.score().objective() > 0.0)
+            auto slow = std::find_if(step_scores.begin(),step_scores.end(),[&slow_point](PointScore const& score) { return score.point() == slow_point; });
+            if (slow == step_scores.end()) continue;
+            ++slow_steps;
+            // With all constraints equally robust, the slow point ranks worse than the fast ones by its running time only
+            for (auto const& score : step_scores) {
+                HELPER_TEST_ASSERT(score.score().hard_failures() == slow->score().hard_failures())
+                HELPER_TEST_ASSERT(score.score().soft_failures() == slow->score().soft_failures())
+                if (score.point() != slow_point) HELPER_TEST_ASSERT(score < *slow)
+            }
+        }
+        HELPER_TEST_ASSERT(slow_steps > 0)
+
+        TaskManager::instance().set_runtime_weight(0.0);
+        TaskManager::instance().clear_scores();
+        TaskManager::instance().clear_concurrency_override();
+    }
+
+    void test_shared_ring_buffer() {
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+        SharedRingBuffer ring(2,sizeof(int));
+        auto pid = fork_process([&ring]() {
+            for (int i=0; i<5; ++i) {
+                std::memcpy(ring.begin_push(),&i,sizeof(i));
+                ring.end_push(sizeof(i));
+            }
+            return 0;
+        });
+        List<int> received;
+        for (size_t i=0; i<5; ++i) {
+            size_t size = 0;
+            auto data = ring.begin_pull(size,-1);
+            HELPER_TEST_EQUALS(size,sizeof(int))
+            int value;
+            std::memcpy(&value,data,sizeof(value));
+            received.push_back(value);
+            ring.end_pull();
+        }
+        HELPER_TEST_EQUALS(received,List<int>({0,1,2,3,4}))
+        size_t size = 0;
+        HELPER_TEST_ASSERT(ring.begin_pull(size,10) == nullptr)
+        terminate_process(pid,1000);
+        HELPER_TEST_ASSERT(has_terminated(pid))
+#endif
+    }
+
+    void test_process_pool() {
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+        ThreadManager::instance().set_concurrency(ThreadManager::instance().maximum_concurrency());
+        TaskManager::instance().set_isolation(RunnerIsolation::PROCESS);
+        TaskManager::instance().set_process_task_timeout(std::chrono::milliseconds(300));
+        TaskManager::instance().clear_scores();
+
+        Configuration<P> cfg;
+        cfg.set_order(1,8);
+        P p(cfg);
+        auto constraint = ConstraintBuilder<P>([](TaskInput<P> const&, TaskOutput<P> const& o) { return 20.0 - o.y; })
+                .set_objective_impact(ConstraintObjectiveImpact::SIGNED)
+                .build();
+        p.set_constraints({constraint});
+        auto runner = std::dynamic_pointer_cast<ProcessPoolRunner<P>>(p.runner());
+        if (runner == nullptr) {
+            HELPER_TEST_PRINT("No concurrency available: worker processes not tested")
+        } else {
+            for (size_t i=0; i<3; ++i) {
+                runner->push({2.0,8});
+                auto output = runner->pull();
+                HELPER_TEST_ASSERT(output.y >= 2.0 and output.y <= 16.0)
+            }
+            HELPER_TEST_EQUALS(runner->restarts(),0)
+
+            runner->push({2.0,0});
+            HELPER_TEST_FAIL(runner->pull())
+            HELPER_TEST_ASSERT(runner->restarts() > 0)
+
+            runner->push({2.0,8});
+            auto output = runner->pull();
+            HELPER_TEST_ASSERT(output.y >= 2.0 and output.y <= 16.0)
+
+            auto restarts = runner->restarts();
+            auto start = std::chrono::steady_clock::now();
+            runner->push({2.0,-1});
+            HELPER_TEST_FAIL(runner->pull())
+            HELPER_TEST_ASSERT(std::chrono::steady_clock::now()-start < std::chrono::seconds(10))
+            HELPER_TEST_ASSERT(runner->restarts() > restarts)
+            runner->push({2.0,8});
+            output = runner->pull();
+            HELPER_TEST_ASSERT(output.y >= 2.0 and output.y <= 16.0)
+        }
+
+        TaskManager::instance().set_process_task_timeout(std::chrono::minutes(10));
+        TaskManager::instance().set_isolation(RunnerIsolation::THREAD);
+        TaskManager::instance().clear_scores();
+        ThreadManager::instance().set_concurrency(1);
+#endif
+    }
+
+    void test_fork_snapshot() {
+#if defined(PEXPLORE_HAS_PROCESS_ISOLATION)
+        ThreadManager::instance().set_concurrency(ThreadManager::instance().maximum_concurrency());
+        TaskManager::instance().set_isolation(RunnerIsolation::FORK);
+        TaskManager::instance().set_process_task_timeout(std::chrono::milliseconds(300));
+        TaskManager::instance().clear_scores();
+
+        Configuration<P> cfg;
+        cfg.set_order(1,8);
+        P p(cfg);
+        auto constraint = ConstraintBuilder<P>([](TaskInput<P> const&, TaskOutput<P> const& o) { return 20.0 - o.y; })
+                .set_objective_impact(ConstraintObjectiveImpact::SIGNED)
+                .build();
+        p.set_constraints({constraint});
+        auto runner = std::dynamic_pointer_cast<ForkSnapshotRunner<P>>(p.runner());
+        if (runner == nullptr) {
+            HELPER_TEST_PRINT("No concurrency available: forked processes not tested")
+        } else {
+            for (size_t i=0; i<3; ++i) {
+                runner->push({3.0,8});
+                auto output = runner->pull();
+                HELPER_TEST_ASSERT(output.y >= 3.0 and output.y <= 24.0)
+            }
+            runner->push({3.0,0});
+            HELPER_TEST_FAIL(runner->pull())
+            runner->push({3.0,8});
+            auto output = runner->pull();
+            HELPER_TEST_ASSERT(output.y >= 3.0 and output.y <= 24.0)
+
+            auto start = std::chrono::steady_clock::now();
+            runner->push({3.0,-1});
+            HELPER_TEST_FAIL(runner->pull())
+            HELPER_TEST_ASSERT(std::chrono::steady_clock::now()-start < std::chrono::seconds(10))
+            runner->push({3.0,8});
+            output = runner->pull();
+            HELPER_TEST_ASSERT(output.y >= 3.0 and output.y <= 24.0)
+        }
+
+        TaskManager::instance().set_process_task_timeout(std::chrono::minutes(10));
+        TaskManager::instance().set_isolation(RunnerIsolation::THREAD);
+        TaskManager::instance().clear_scores();
+        ThreadManager::instance().set_concurrency(1);
+#endif
+    }
+
     void test() {
         HELPER_TEST_CALL(test_failure())
         HELPER_TEST_CALL(test_success())
+        HELPER_TEST_CALL(test_static_constraints())
         HELPER_TEST_CALL(test_uses_expensiveclass())
         HELPER_TEST_CALL(test_no_concurrency())
         HELPER_TEST_CALL(test_no_constraining())
         HELPER_TEST_CALL(test_choose_point())
         HELPER_TEST_CALL(test_time_progress_linear_controller())
+        HELPER_TEST_CALL(test_latin_hypercube_initialisation())
+        HELPER_TEST_CALL(test_successive_halving())
+        HELPER_TEST_CALL(test_checkpoint())
+        HELPER_TEST_CALL(test_record_replay())
+        HELPER_TEST_CALL(test_seeded_runs())
+        HELPER_TEST_CALL(test_concurrency_detection())
+        HELPER_TEST_CALL(test_affinity())
+        HELPER_TEST_CALL(test_batch())
+        HELPER_TEST_CALL(test_set_concurrency())
+        HELPER_TEST_CALL(test_reuse_runner())
+        HELPER_TEST_CALL(test_real_time())
+        HELPER_TEST_CALL(test_runtime_weight())
+        HELPER_TEST_CALL(test_shared_ring_buffer())
+        HELPER_TEST_CALL(test_process_pool())
+        HELPER_TEST_CALL(test_fork_snapshot())
     }
 };
 